@@ -0,0 +1,100 @@
+// Match-state arena (see arena.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "arena.h"
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2             // From <numaif.h>; called raw to avoid libnuma
+#endif
+
+static int huge_pages = 1;
+static int numa_node = -1;
+
+void arena_set_huge_pages(int enabled) {
+    huge_pages = enabled;
+}
+
+void arena_set_numa_node(int node) {
+    numa_node = node;
+}
+
+size_t arena_block_size(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+// Map size bytes; huge-page sized arenas are aligned to a huge page by
+// over-mapping and trimming the ends
+static char *map_region(size_t size) {
+    int huge = huge_pages && size >= ARENA_HUGE_PAGE;
+    size_t len = huge ? size + ARENA_HUGE_PAGE : size;
+    char *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+
+    if (huge) {
+        uintptr_t start = ((uintptr_t)p + ARENA_HUGE_PAGE - 1) & ~(uintptr_t)(ARENA_HUGE_PAGE - 1);
+        size_t head = start - (uintptr_t)p;
+        if (head > 0)
+            munmap(p, head);
+        munmap((char *)start + size, len - head - size);
+        p = (char *)start;
+        // Only advice: kernels without THP just keep small pages
+        madvise(p, size, MADV_HUGEPAGE);
+    }
+
+#ifdef SYS_mbind
+    if (numa_node >= 0 && numa_node < (int)(8 * sizeof(unsigned long))) {
+        unsigned long mask = 1UL << numa_node;
+        // Also advice: on a single-node host the call fails harmlessly
+        syscall(SYS_mbind, p, size, MPOL_BIND, &mask, 8 * sizeof(mask) + 1, 0);
+    }
+#endif
+    return p;
+}
+
+int arena_prepare(Arena *arena, size_t size) {
+    arena->used = 0;
+    if (arena->base && arena->capacity >= size)
+        return 0;
+
+    arena_release(arena);
+    long page = sysconf(_SC_PAGESIZE);
+    size_t capacity = (size + (size_t)page - 1) & ~(size_t)(page - 1);
+    if (capacity == 0)
+        capacity = (size_t)page;
+    char *p = map_region(capacity);
+    if (!p)
+        return -1;
+    arena->base = p;
+    arena->capacity = capacity;
+    return 0;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    size_t block = arena_block_size(size);
+    if (block > arena->capacity - arena->used) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    void *p = arena->base + arena->used;
+    arena->used += block;
+    return p;
+}
+
+void arena_reset(Arena *arena) {
+    arena->used = 0;
+}
+
+void arena_release(Arena *arena) {
+    if (arena->base)
+        munmap(arena->base, arena->capacity);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
@@ -0,0 +1,494 @@
+/*
+ * Tug-of-War benchmark suite
+ * Microbenchmarks for the per-tick engine steps and align_team over
+ * growing roster sizes and for mirror_to_shared_memory (which copies a
+ * fixed number of players), plus macrobenchmarks
+ * for headless matches and the IPC primitives the game uses, and the
+ * scaling of chunked ticks with the thread count.
+ * Results are written as JSON so two runs can be compared directly.
+ *
+ * Usage: ./tug_bench [output.json] [--max-players N] [--min-time MS]
+ *                   [--kernel NAME]
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "config.h"
+#include "game.h"
+#include "log.h"
+#include "kernel.h"
+#include "pool.h"
+#include "tick_pool.h"
+
+// Roster sizes run from 4 players per team up to this many (x4 each step)
+#define BENCH_MAX_PLAYERS (1 << 20)
+
+// Roster for the chunked tick scaling runs
+#define BENCH_CHUNKED_PLAYERS (1 << 18)
+
+// Ticks a roster plays before it is put back in its starting state
+// (10 game seconds: players fall and recover, nobody runs out of energy)
+#define BENCH_RESET_TICKS 100
+
+
+// Number of messages used by the IPC macrobenchmarks
+#define IPC_PIPE_MESSAGES  200000
+#define IPC_SIGNAL_ROUNDS  20000
+
+typedef void (*bench_fn)(void);
+
+static double min_time_sec = 0.05;   // Minimum measuring time per case
+static FILE  *json = NULL;
+static int    first_entry = 1;
+
+static Player *start_roster = NULL;  // Roster as initialize_game() drew it
+static float   start_rope = 0.0f;
+static long    start_ticks = 0;
+
+// ---------------------------------------------------------------------
+// Timing helpers
+// ---------------------------------------------------------------------
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Keep the freshly initialized match so every measurement can go back to it
+static void save_roster(void) {
+    size_t n = (size_t)config.players_per_team;
+    start_roster = realloc(start_roster, (size_t)config.num_teams * n * sizeof(Player));
+    for (int t = 0; t < config.num_teams; t++)
+        memcpy(&start_roster[t * n], teams[t], n * sizeof(Player));
+    start_rope = rope_position;
+    start_ticks = sim_ticks;
+}
+
+static void restore_roster(void) {
+    size_t n = (size_t)config.players_per_team;
+    for (int t = 0; t < config.num_teams; t++)
+        memcpy(teams[t], &start_roster[t * n], n * sizeof(Player));
+    rope_position = start_rope;
+    sim_ticks = start_ticks;
+}
+
+// Run fn until at least min_time_sec has passed (and at least 3 calls).
+// Every call is one tick of game time, so fallen players recover, and
+// after BENCH_RESET_TICKS the roster is restored (untimed), so energies
+// never decay into an idle team. Calls run in batches that double while
+// they are short, so reading the clock does not dominate cheap calls on
+// small rosters. Returns nanoseconds per call and stores the call count
+// in *iters.
+static double time_ticks(bench_fn fn, long *iters) {
+    long n = 0;
+    long batch = 1;
+    long since_reset = 0;
+    double elapsed = 0.0;
+    restore_roster();
+    do {
+        if (since_reset + batch > BENCH_RESET_TICKS) {
+            restore_roster();
+            since_reset = 0;
+        }
+        double start = now_sec();
+        for (long b = 0; b < batch; b++) {
+            fn();
+            sim_ticks++;
+        }
+        elapsed += now_sec() - start;
+        n += batch;
+        since_reset += batch;
+        if (elapsed < min_time_sec / 16.0)
+            batch = batch * 2 < BENCH_RESET_TICKS ? batch * 2 : BENCH_RESET_TICKS;
+    } while (n < 3 || elapsed < min_time_sec);
+    restore_roster();
+    *iters = n;
+    return elapsed * 1e9 / (double)n;
+}
+
+// ---------------------------------------------------------------------
+// JSON output
+// ---------------------------------------------------------------------
+static void json_entry_start(void) {
+    fprintf(json, first_entry ? "\n    " : ",\n    ");
+    first_entry = 0;
+}
+
+static void json_micro(const char *name, int players, double ns, long iters) {
+    json_entry_start();
+    fprintf(json, "{\"name\": \"%s\", \"players_per_team\": %d, "
+                  "\"iterations\": %ld, \"ns_per_call\": %.1f, "
+                  "\"ns_per_player\": %.3f}",
+            name, players, iters, ns,
+            ns / ((double)players * (double)config.num_teams));
+}
+
+// ---------------------------------------------------------------------
+// Microbenchmarks
+// ---------------------------------------------------------------------
+// Steady state: ranking kept from the previous call while energies decay
+// (includes one request_energy_reports_partial, measured separately above)
+static void bench_align_team(void) {
+    request_energy_reports_partial();
+    align_team(0);
+}
+
+// Cold start: every call sorts the roster from scratch
+static void bench_align_team_full(void) {
+    reset_team_order();
+    align_team(0);
+}
+
+static void run_micro(int players, int first) {
+    static const struct {
+        const char *name;
+        bench_fn fn;
+        int constant;   // Cost does not depend on the roster: timed once
+    } cases[] = {
+        { "check_player_falls_partial",     check_player_falls_partial,     0 },
+        { "recover_players_partial",        recover_players_partial,        0 },
+        { "request_energy_reports_partial", request_energy_reports_partial, 0 },
+        { "update_rope_position_partial",   update_rope_position_partial,   0 },
+        // Copies at most PLAYERS_PER_TEAM players per team
+        { "mirror_to_shared_memory",        mirror_to_shared_memory,        1 },
+        { "align_team_full_sort",           bench_align_team_full,          0 },
+        { "align_team_incremental",         bench_align_team,               0 },
+    };
+
+    config.players_per_team = players;
+    reset_match_state();
+    derive_tick_params();
+    headless = 1;
+    game_srand(12345);
+    initialize_game();
+    save_roster();
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (cases[i].constant && !first)
+            continue;
+        long iters;
+        double ns = time_ticks(cases[i].fn, &iters);
+        json_micro(cases[i].name, players, ns, iters);
+        fprintf(stderr, "  %-32s %8d players/team %14.1f ns/call\n",
+                cases[i].name, players, ns);
+    }
+
+    // The kernel steps again for every other tick kernel, as "step[kernel]"
+    for (int k = 0; k < tick_kernel_count; k++) {
+        const TickKernel *kernel = &tick_kernels[k];
+        if (kernel == tick_kernel)
+            continue;
+        const struct {
+            const char *step;
+            bench_fn fn;
+        } steps[] = {
+            { "request_energy_reports_partial", kernel->energy_reports },
+            { "update_rope_position_partial",   kernel->rope_update },
+        };
+        for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s[%s]", steps[i].step, kernel->name);
+            long iters;
+            double ns = time_ticks(steps[i].fn, &iters);
+            json_micro(name, players, ns, iters);
+            fprintf(stderr, "  %-32s %8d players/team %14.1f ns/call\n", name, players, ns);
+        }
+    }
+
+    free_game();
+}
+
+// ---------------------------------------------------------------------
+// Shape-specialized kernels against the generic code, per kernel step
+// ---------------------------------------------------------------------
+static void run_specialized(int players) {
+    config.players_per_team = players;
+    reset_match_state();
+    derive_tick_params();
+    headless = 1;
+    game_srand(12345);
+    initialize_game();
+    save_roster();
+
+    for (int k = 0; k < tick_kernel_count; k++) {
+        const TickKernel *generic = &tick_kernels[k];
+        const TickKernel *special = tick_kernel_specialize(generic, config.num_teams, players);
+        if (special == generic)
+            continue;
+        const struct {
+            const char *step;
+            bench_fn generic_fn;
+            bench_fn special_fn;
+        } steps[] = {
+            { "request_energy_reports_partial", generic->energy_reports, special->energy_reports },
+            { "update_rope_position_partial",   generic->rope_update,    special->rope_update },
+        };
+        for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+            if (steps[i].special_fn == steps[i].generic_fn)
+                continue;  // This shape runs the generic step
+            long generic_iters, special_iters;
+            double generic_ns = time_ticks(steps[i].generic_fn, &generic_iters);
+            double special_ns = time_ticks(steps[i].special_fn, &special_iters);
+            json_entry_start();
+            fprintf(json, "{\"name\": \"specialized_kernel\", \"step\": \"%s\", "
+                          "\"kernel\": \"%s\", \"players_per_team\": %d, "
+                          "\"generic_ns_per_call\": %.1f, \"specialized_ns_per_call\": %.1f, "
+                          "\"speedup\": %.2f}",
+                    steps[i].step, special->name, players,
+                    generic_ns, special_ns, generic_ns / special_ns);
+            fprintf(stderr, "  %-32s %-10s %10.1f -> %8.1f ns/call (x%.2f)\n",
+                    steps[i].step, special->name, generic_ns, special_ns,
+                    generic_ns / special_ns);
+        }
+    }
+
+    free_game();
+}
+
+// ---------------------------------------------------------------------
+// Chunked ticks (tick_pool.h) on 1, 2, 4, ... threads up to the core
+// count, against the serial tick steps
+// ---------------------------------------------------------------------
+static void serial_tick(void) {
+    check_player_falls_partial();
+    recover_players_partial();
+    request_energy_reports_partial();
+    update_rope_position_partial();
+}
+
+static void run_chunked(int players) {
+    config.players_per_team = players;
+    reset_match_state();
+    derive_tick_params();
+    headless = 1;
+    game_srand(12345);
+    initialize_game();
+    save_roster();
+
+    long iters;
+    double serial_ns = time_ticks(serial_tick, &iters);
+    double one_thread_ns = 0.0;
+    int cores = pool_default_workers();
+    if (cores > TICK_POOL_MAX_THREADS)
+        cores = TICK_POOL_MAX_THREADS;
+    int counts[16], ncounts = 0;
+    for (int n = 1; n < cores && ncounts < 15; n *= 2)
+        counts[ncounts++] = n;
+    counts[ncounts++] = cores;
+
+    for (int c = 0; c < ncounts; c++) {
+        int n = counts[c];
+        tick_pool_set_threads(n);
+        double ns = time_ticks(tick_pool_tick, &iters);
+        if (n == 1)
+            one_thread_ns = ns;
+        json_entry_start();
+        fprintf(json, "{\"name\": \"chunked_tick\", \"players_per_team\": %d, "
+                      "\"threads\": %d, \"iterations\": %ld, \"ns_per_tick\": %.1f, "
+                      "\"serial_ns_per_tick\": %.1f, \"speedup\": %.2f}",
+                players, n, iters, ns, serial_ns, one_thread_ns / ns);
+        fprintf(stderr, "  %-32s %8d players/team %3d threads %12.1f ns/tick (x%.2f)\n",
+                "chunked_tick", players, n, ns, one_thread_ns / ns);
+    }
+    tick_pool_set_threads(0);
+
+    free_game();
+}
+
+// ---------------------------------------------------------------------
+// Macrobenchmark: complete headless matches with the default roster
+// ---------------------------------------------------------------------
+static void run_headless_matches(int players) {
+    config.players_per_team = players;
+    long matches = 0;
+    long ticks = 0;
+    unsigned int seed = 1;
+    double budget = min_time_sec * 20.0;
+    double start = now_sec();
+    double elapsed = 0.0;
+    do {
+        run_headless_match(seed++, NULL);
+        ticks += sim_ticks;
+        matches++;
+        elapsed = now_sec() - start;
+    } while (elapsed < budget);
+
+    json_entry_start();
+    fprintf(json, "{\"name\": \"headless_match\", \"players_per_team\": %d, "
+                  "\"matches\": %ld, \"seconds\": %.3f, "
+                  "\"matches_per_sec\": %.1f, \"ticks_per_sec\": %.1f}",
+            players, matches, elapsed,
+            (double)matches / elapsed, (double)ticks / elapsed);
+    fprintf(stderr, "  %-32s %8d players/team %14.1f matches/s\n",
+            "headless_match", players, (double)matches / elapsed);
+}
+
+// ---------------------------------------------------------------------
+// Macrobenchmark: energy reports through a pipe (one float per message)
+// ---------------------------------------------------------------------
+static void run_ipc_pipe(void) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe failed");
+        return;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        float energy = 100.0f;
+        for (int i = 0; i < IPC_PIPE_MESSAGES; i++) {
+            if (write(fds[1], &energy, sizeof(energy)) != sizeof(energy))
+                _exit(1);
+            energy -= 0.001f;
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+
+    double start = now_sec();
+    float energy;
+    long received = 0;
+    while (read(fds[0], &energy, sizeof(energy)) == sizeof(energy)) {
+        received++;
+    }
+    double elapsed = now_sec() - start;
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+
+    json_entry_start();
+    fprintf(json, "{\"name\": \"ipc_pipe_energy_report\", \"messages\": %ld, "
+                  "\"seconds\": %.3f, \"messages_per_sec\": %.1f, "
+                  "\"ns_per_message\": %.1f}",
+            received, elapsed, (double)received / elapsed,
+            elapsed * 1e9 / (double)(received ? received : 1));
+    fprintf(stderr, "  %-32s %14.1f msgs/s\n",
+            "ipc_pipe_energy_report", (double)received / elapsed);
+}
+
+// ---------------------------------------------------------------------
+// Macrobenchmark: signal round trip (referee -> player -> referee),
+// the path notify_round_result uses to reach player processes
+// ---------------------------------------------------------------------
+static void run_ipc_signal(void) {
+    sigset_t set, old;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+    sigaddset(&set, SIGUSR2);
+    sigprocmask(SIG_BLOCK, &set, &old);
+
+    pid_t parent = getpid();
+    pid_t pid = fork();
+    if (pid == 0) {
+        sigset_t wait_set;
+        sigemptyset(&wait_set);
+        sigaddset(&wait_set, SIGUSR1);
+        for (int i = 0; i < IPC_SIGNAL_ROUNDS; i++) {
+            int sig;
+            sigwait(&wait_set, &sig);
+            kill(parent, SIGUSR2);
+        }
+        _exit(0);
+    }
+
+    sigset_t reply_set;
+    sigemptyset(&reply_set);
+    sigaddset(&reply_set, SIGUSR2);
+    double start = now_sec();
+    for (int i = 0; i < IPC_SIGNAL_ROUNDS; i++) {
+        int sig;
+        kill(pid, SIGUSR1);
+        sigwait(&reply_set, &sig);
+    }
+    double elapsed = now_sec() - start;
+    waitpid(pid, NULL, 0);
+    sigprocmask(SIG_SETMASK, &old, NULL);
+
+    json_entry_start();
+    fprintf(json, "{\"name\": \"ipc_signal_round_trip\", \"round_trips\": %d, "
+                  "\"seconds\": %.3f, \"ns_per_round_trip\": %.1f}",
+            IPC_SIGNAL_ROUNDS, elapsed, elapsed * 1e9 / IPC_SIGNAL_ROUNDS);
+    fprintf(stderr, "  %-32s %14.1f ns/round trip\n",
+            "ipc_signal_round_trip", elapsed * 1e9 / IPC_SIGNAL_ROUNDS);
+}
+
+// ---------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const char *out_path = "bench_results.json";
+    int max_players = BENCH_MAX_PLAYERS;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max-players") == 0 && i + 1 < argc) {
+            max_players = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_time_sec = atof(argv[++i]) / 1000.0;
+        } else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            tick_kernel = tick_kernel_find(argv[++i]);
+            if (!tick_kernel) {
+                fprintf(stderr, "Unknown tick kernel '%s'\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            out_path = argv[i];
+        }
+    }
+
+    json = fopen(out_path, "w");
+    if (!json) {
+        perror("Error opening benchmark output");
+        return EXIT_FAILURE;
+    }
+    if (map_shared_state() != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Measure the engine the way fast-forward runs use it: game narrative
+    // is filtered before any formatting, and stdout goes nowhere
+    log_set_level(LOG_LEVEL_WARN);
+    if (!freopen("/dev/null", "w", stdout)) {
+        perror("freopen failed");
+        return EXIT_FAILURE;
+    }
+
+    time_t started = time(NULL);
+    fprintf(json, "{\n  \"suite\": \"tug_of_war\",\n");
+    fprintf(json, "  \"timestamp\": %ld,\n", (long)started);
+    fprintf(json, "  \"num_teams\": %d,\n", config.num_teams);
+    fprintf(json, "  \"kernel\": \"%s\",\n", tick_kernel->name);
+    fprintf(json, "  \"min_time_ms\": %.1f,\n", min_time_sec * 1000.0);
+    fprintf(json, "  \"results\": [");
+
+    fprintf(stderr, "Microbenchmarks:\n");
+    for (int players = 4; players <= max_players; players *= 4) {
+        run_micro(players, players == 4);
+    }
+
+    fprintf(stderr, "Specialized kernels:\n");
+    static const int shapes[] = { 4, 8, 16 };
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        run_specialized(shapes[i]);
+    }
+
+    fprintf(stderr, "Chunked ticks:\n");
+    run_chunked(max_players < BENCH_CHUNKED_PLAYERS ? max_players : BENCH_CHUNKED_PLAYERS);
+
+    fprintf(stderr, "Macrobenchmarks:\n");
+    run_headless_matches(PLAYERS_PER_TEAM);
+    run_ipc_pipe();
+    run_ipc_signal();
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    fprintf(stderr, "Results written to %s\n", out_path);
+    return 0;
+}
@@ -0,0 +1,220 @@
+// Content-addressed match result cache (see cache.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "cache.h"
+#include "kernel.h"
+#include "strategy.h"
+#include "tick_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define CACHE_MAGIC "TUGCACHE"
+#define CACHE_FORMAT_VERSION 1
+
+// File header; followed by key_len bytes of canonical key text, then records
+typedef struct {
+    char     magic[8];
+    uint32_t format_version;
+    uint32_t key_len;
+} CacheHeader;
+
+typedef struct {
+    uint32_t    seed;
+    MatchResult result;
+} CacheRecord;
+
+static const char *cache_dir = NULL;
+
+void cache_set_dir(const char *dir) {
+    cache_dir = dir;
+}
+
+int cache_enabled(void) {
+    return cache_dir != NULL;
+}
+
+// ---------------------------------------------------------------------
+// Keys
+// ---------------------------------------------------------------------
+size_t cache_canonical_key(const GameConfig *cfg, char *buf, size_t len) {
+    size_t used = (size_t)snprintf(buf, len, "engine=%d;kernel=%s;strategy1=%s;strategy2=%s;",
+                                   ENGINE_VERSION, tick_kernel->name,
+                                   strategy_name(0), strategy_name(1));
+    // A plugin is identified by its contents, not only by its path
+    for (int t = 0; t < NUM_TEAMS && used < len; t++) {
+        if (strategy_digest(t))
+            used += (size_t)snprintf(buf + used, len - used, "strategy%d_so=%016llx;",
+                                     t + 1, (unsigned long long)strategy_digest(t));
+    }
+    if (tick_chunked && used < len)
+        used += (size_t)snprintf(buf + used, len - used, "ticks=chunked;");
+    for (int i = 0; i < config_field_count && used < len; i++) {
+        const ConfigField *f = &config_fields[i];
+        used += (size_t)snprintf(buf + used, len - used, "%s=%.17g;",
+                                 f->name, config_get_field(cfg, f));
+    }
+    return used < len ? used : len - 1;
+}
+
+static uint64_t fnv1a64(const char *data, size_t len) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// ---------------------------------------------------------------------
+// Loading
+// ---------------------------------------------------------------------
+static int compare_records(const void *a, const void *b) {
+    uint32_t sa = ((const CacheRecord *)a)->seed;
+    uint32_t sb = ((const CacheRecord *)b)->seed;
+    return (sa > sb) - (sa < sb);
+}
+
+// Read the records of an existing cache file whose header matches key
+static void load_records(CachePoint *point, int fd, const char *key, size_t key_len) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CacheHeader) + key_len)
+        return;
+    char *data = malloc((size_t)st.st_size);
+    if (!data)
+        return;
+    if (pread(fd, data, (size_t)st.st_size, 0) != st.st_size) {
+        free(data);
+        return;
+    }
+
+    const CacheHeader *hdr = (const CacheHeader *)data;
+    if (memcmp(hdr->magic, CACHE_MAGIC, 8) != 0 ||
+        hdr->format_version != CACHE_FORMAT_VERSION ||
+        hdr->key_len != key_len ||
+        memcmp(data + sizeof(CacheHeader), key, key_len) != 0) {
+        free(data);  // Hash collision or foreign file: treat as empty
+        return;
+    }
+
+    size_t offset = sizeof(CacheHeader) + key_len;
+    int n = (int)(((size_t)st.st_size - offset) / sizeof(CacheRecord));
+    CacheRecord *records = malloc((size_t)(n > 0 ? n : 1) * sizeof(CacheRecord));
+    if (records) {
+        memcpy(records, data + offset, (size_t)n * sizeof(CacheRecord));
+        qsort(records, (size_t)n, sizeof(CacheRecord), compare_records);
+        point->seeds = malloc((size_t)(n > 0 ? n : 1) * sizeof(unsigned int));
+        point->results = malloc((size_t)(n > 0 ? n : 1) * sizeof(MatchResult));
+        if (point->seeds && point->results) {
+            for (int i = 0; i < n; i++) {
+                point->seeds[i] = records[i].seed;
+                point->results[i] = records[i].result;
+            }
+            point->count = n;
+            point->capacity = n;
+        }
+        free(records);
+    }
+    free(data);
+}
+
+int cache_open(const GameConfig *cfg, CachePoint *point) {
+    memset(point, 0, sizeof(*point));
+    point->fd = -1;
+    if (!cache_dir)
+        return -1;
+
+    char key[1024];
+    size_t key_len = cache_canonical_key(cfg, key, sizeof(key));
+    snprintf(point->path, sizeof(point->path), "%s/%016llx.cache",
+             cache_dir, (unsigned long long)fnv1a64(key, key_len));
+    mkdir(cache_dir, 0755);
+
+    int fd = open(point->path, O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd < 0 && errno == ENOENT) {
+        // Create with its header in a temp file, then link it into place;
+        // link fails if another worker got there first, which is fine
+        char tmp[640];
+        snprintf(tmp, sizeof(tmp), "%s.%d.tmp", point->path, (int)getpid());
+        int tfd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (tfd >= 0) {
+            CacheHeader hdr;
+            memcpy(hdr.magic, CACHE_MAGIC, 8);
+            hdr.format_version = CACHE_FORMAT_VERSION;
+            hdr.key_len = (uint32_t)key_len;
+            int ok = write(tfd, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr) &&
+                     write(tfd, key, key_len) == (ssize_t)key_len;
+            close(tfd);
+            if (ok)
+                (void)link(tmp, point->path);
+            unlink(tmp);
+        }
+        fd = open(point->path, O_RDWR | O_APPEND | O_CLOEXEC);
+    }
+    if (fd < 0)
+        return -1;
+
+    load_records(point, fd, key, key_len);
+    // Only append to files whose header is ours
+    if (point->count == 0) {
+        CacheHeader hdr;
+        char stored[1024];
+        if (pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) ||
+            memcmp(hdr.magic, CACHE_MAGIC, 8) != 0 || hdr.key_len != key_len ||
+            pread(fd, stored, key_len, sizeof(hdr)) != (ssize_t)key_len ||
+            memcmp(stored, key, key_len) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    point->fd = fd;
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Lookup and store
+// ---------------------------------------------------------------------
+int cache_lookup(const CachePoint *point, unsigned int seed, MatchResult *result) {
+    int lo = 0, hi = point->count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (point->seeds[mid] == seed) {
+            *result = point->results[mid];
+            return 1;
+        }
+        if (point->seeds[mid] < seed)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return 0;
+}
+
+void cache_store(CachePoint *point, unsigned int seed, const MatchResult *result) {
+    if (point->fd < 0)
+        return;
+    // One small O_APPEND write per record, so concurrent workers never interleave
+    CacheRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.seed = seed;
+    rec.result = *result;
+    if (write(point->fd, &rec, sizeof(rec)) != (ssize_t)sizeof(rec)) {
+        close(point->fd);
+        point->fd = -1;
+    }
+}
+
+void cache_close(CachePoint *point) {
+    if (point->fd >= 0)
+        close(point->fd);
+    free(point->seeds);
+    free(point->results);
+    memset(point, 0, sizeof(*point));
+    point->fd = -1;
+}
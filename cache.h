@@ -0,0 +1,46 @@
+// cache.h
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include "config.h"
+#include "game.h"
+
+// ----------------------------------------------------------
+// On-disk cache of headless match results.
+// Results are content-addressed: a file name is the 64-bit FNV-1a hash
+// of the canonical text of a GameConfig plus ENGINE_VERSION, the tick
+// kernel (kernel.h), both teams' strategies (strategy.h; plugins also by
+// a hash of their shared object) and chunked ticks (tick_pool.h) when
+// selected, and the file
+// holds one record per seed played with that configuration. The canonical
+// text is stored in the file header and checked on load, so a hash
+// collision is treated as a miss.
+// ----------------------------------------------------------
+
+#define CACHE_DEFAULT_DIR ".tug_cache"
+
+// Results cached for one configuration
+typedef struct {
+    char          path[600];
+    int           fd;          // Open for appending new records, -1 if unusable
+    int           count;
+    int           capacity;
+    unsigned int *seeds;       // Sorted, parallel to results
+    MatchResult  *results;
+} CachePoint;
+
+// Directory for cache files; NULL disables the cache
+void cache_set_dir(const char *dir);
+int  cache_enabled(void);
+
+// Canonical description of everything that determines a match result
+// (except the seed); returns its length
+size_t cache_canonical_key(const GameConfig *cfg, char *buf, size_t len);
+
+int  cache_open(const GameConfig *cfg, CachePoint *point);
+int  cache_lookup(const CachePoint *point, unsigned int seed, MatchResult *result);
+void cache_store(CachePoint *point, unsigned int seed, const MatchResult *result);
+void cache_close(CachePoint *point);
+
+#endif  // CACHE_H
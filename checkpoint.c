@@ -0,0 +1,225 @@
+// Engine checkpoints (see checkpoint.h)
+#define _POSIX_C_SOURCE 200809L
+
+#include "checkpoint.h"
+#include "config.h"
+#include "game.h"
+#include "game_clock.h"
+#include "kernel.h"
+#include "strategy.h"
+#include "tick_pool.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define CHECKPOINT_MAGIC "TUGCKPT\0"
+#define CHECKPOINT_FORMAT_VERSION 5
+
+// File layout: header, GameConfig, CheckpointState, then one Player per
+// team and position (team-major). recover_time is in game-clock
+// nanoseconds, and pids are not stored.
+typedef struct {
+    char     magic[8];
+    uint32_t format_version;
+    uint32_t engine_version;
+    uint32_t config_size;       // Layout checks: the structs are written raw
+    uint32_t player_size;
+} CheckpointHeader;
+
+typedef struct {
+    int64_t  sim_ticks;
+    uint32_t rng;
+    int32_t  game_active;
+    int32_t  round_number;
+    float    rope_position;
+    int32_t  team_round_wins[NUM_TEAMS];
+    int32_t  team_consecutive_wins[NUM_TEAMS];
+    float    team_efforts[NUM_TEAMS];
+    char     kernel[16];        // Tick kernel the match was played with
+    char     strategies[NUM_TEAMS][STRATEGY_NAME_MAX];
+    int32_t  chunked_ticks;     // Played with tick_pool.h's chunked ticks
+} CheckpointState;
+
+static const char *periodic_path = NULL;
+static long periodic_ticks = 0;
+
+// ---------------------------------------------------------------------
+// Saving
+// ---------------------------------------------------------------------
+int checkpoint_save(const char *path, char *err, size_t err_len) {
+    char tmp[600];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *file = fopen(tmp, "wb");
+    if (!file) {
+        snprintf(err, err_len, "%s: %s", tmp, strerror(errno));
+        return -1;
+    }
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.format_version = CHECKPOINT_FORMAT_VERSION;
+    header.engine_version = ENGINE_VERSION;
+    header.config_size = sizeof(GameConfig);
+    header.player_size = sizeof(Player);
+
+    CheckpointState state;
+    memset(&state, 0, sizeof(state));
+    state.sim_ticks    = sim_ticks;
+    state.rng          = game_rng;
+    state.game_active  = game_active;
+    state.round_number = round_number;
+    state.rope_position = rope_position;
+    snprintf(state.kernel, sizeof(state.kernel), "%s", tick_kernel->name);
+    state.chunked_ticks = tick_chunked;
+    for (int t = 0; t < NUM_TEAMS; t++)
+        snprintf(state.strategies[t], sizeof(state.strategies[t]), "%s", strategy_name(t));
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        state.team_round_wins[t]       = team_round_wins[t];
+        state.team_consecutive_wins[t] = team_consecutive_wins[t];
+        state.team_efforts[t]          = team_efforts[t];
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(&config, sizeof(config), 1, file) == 1 &&
+             fwrite(&state, sizeof(state), 1, file) == 1;
+    for (int t = 0; ok && t < config.num_teams; t++) {
+        for (int p = 0; ok && p < config.players_per_team; p++) {
+            Player pl = teams[t][p];
+            pl.pid = 0;
+            ok = fwrite(&pl, sizeof(pl), 1, file) == 1;
+        }
+    }
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0)
+        ok = 0;
+    if (!ok) {
+        snprintf(err, err_len, "%s: %s", tmp, strerror(errno));
+        unlink(tmp);
+        return -1;
+    }
+
+    // A crash mid-write leaves the previous checkpoint intact
+    if (rename(tmp, path) != 0) {
+        snprintf(err, err_len, "%s: %s", path, strerror(errno));
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Restoring
+// ---------------------------------------------------------------------
+int checkpoint_restore(const char *path, char *err, size_t err_len) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        snprintf(err, err_len, "%s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    CheckpointHeader header;
+    GameConfig saved;
+    CheckpointState state;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        snprintf(err, err_len, "%s: not a checkpoint file", path);
+        fclose(file);
+        return -1;
+    }
+    if (header.format_version != CHECKPOINT_FORMAT_VERSION ||
+        header.config_size != sizeof(GameConfig) || header.player_size != sizeof(Player)) {
+        snprintf(err, err_len, "%s: unsupported checkpoint format %u",
+                 path, header.format_version);
+        fclose(file);
+        return -1;
+    }
+    if (header.engine_version != ENGINE_VERSION) {
+        snprintf(err, err_len, "%s: written by engine version %u, this is %d",
+                 path, header.engine_version, ENGINE_VERSION);
+        fclose(file);
+        return -1;
+    }
+    if (fread(&saved, sizeof(saved), 1, file) != 1 ||
+        fread(&state, sizeof(state), 1, file) != 1) {
+        snprintf(err, err_len, "%s: truncated", path);
+        fclose(file);
+        return -1;
+    }
+    if (config_validate(&saved, err, err_len) != 0) {
+        fclose(file);
+        return -1;
+    }
+    state.kernel[sizeof(state.kernel) - 1] = '\0';
+    const TickKernel *kernel = tick_kernel_find(state.kernel);
+    if (!kernel) {
+        snprintf(err, err_len, "%s: unknown tick kernel", path);
+        fclose(file);
+        return -1;
+    }
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        state.strategies[t][STRATEGY_NAME_MAX - 1] = '\0';
+        if (strategy_select(t, state.strategies[t], err, err_len) != 0) {
+            fclose(file);
+            return -1;
+        }
+    }
+
+    // Sizes come from the checkpoint, not from config.txt
+    config = saved;
+    derive_tick_params();
+    reset_match_state();
+    allocate_game();
+
+    for (int t = 0; t < config.num_teams; t++) {
+        for (int p = 0; p < config.players_per_team; p++) {
+            Player *pl = &teams[t][p];
+            if (fread(pl, sizeof(*pl), 1, file) != 1) {
+                snprintf(err, err_len, "%s: truncated", path);
+                fclose(file);
+                free_game();
+                return -1;
+            }
+            pl->pid = 0;
+        }
+    }
+    fclose(file);
+
+    tick_kernel   = kernel;
+    tick_chunked  = state.chunked_ticks != 0;
+    sim_ticks     = (long)state.sim_ticks;
+    game_clock_start((int64_t)sim_ticks * TICK_NSEC);
+    game_rng      = state.rng;
+    game_active   = state.game_active;
+    round_number  = state.round_number;
+    rope_position = state.rope_position;
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        team_round_wins[t]       = state.team_round_wins[t];
+        team_consecutive_wins[t] = state.team_consecutive_wins[t];
+        team_efforts[t]          = state.team_efforts[t];
+    }
+    mirror_to_shared_memory();
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Periodic checkpoints
+// ---------------------------------------------------------------------
+void checkpoint_enable(const char *path, int interval_seconds) {
+    periodic_path = interval_seconds > 0 ? path : NULL;
+    periodic_ticks = (long)interval_seconds * TICKS_PER_SECOND;
+}
+
+void checkpoint_tick(void) {
+    if (!periodic_path || sim_ticks % periodic_ticks != 0)
+        return;
+    char err[256];
+    if (checkpoint_save(periodic_path, err, sizeof(err)) != 0)
+        LOG_WARN("Checkpoint failed: %s\n", err);
+    else
+        LOG_DEBUG("Checkpoint written at tick %ld\n", sim_ticks);
+}
@@ -0,0 +1,32 @@
+// checkpoint.h
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stddef.h>
+
+// ----------------------------------------------------------
+// Checkpoints: the complete engine state (config, tick kernel, effort
+// strategies, serial or chunked ticks, players including pending recovery
+// times, rope, round, scores, tick count and RNG state) in a versioned
+// binary file. Restoring one and playing on gives exactly the match that
+// would have followed the saved tick.
+// ----------------------------------------------------------
+
+// Default spacing of periodic checkpoints, in game seconds
+#define CHECKPOINT_DEFAULT_INTERVAL 10
+
+// Write the current state to path (via a temporary file and rename)
+int  checkpoint_save(const char *path, char *err, size_t err_len);
+
+// Replace config and all match state with the contents of path. Allocates
+// the match like initialize_game(); shared_state must already be mapped.
+// The game clock carries on from the saved tick.
+int  checkpoint_restore(const char *path, char *err, size_t err_len);
+
+// Save to path every interval_seconds of game time (0 disables)
+void checkpoint_enable(const char *path, int interval_seconds);
+
+// Called by the referee after each whole tick
+void checkpoint_tick(void);
+
+#endif  // CHECKPOINT_H
@@ -1,7 +1,12 @@
 #include "config.h"
+#include "log.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
 
 GameConfig config = {
     .num_teams = 2,
@@ -19,46 +24,216 @@ GameConfig config = {
     .range = 20
 };
 
-void initialize_config(const char *config_file) {
+// The engine is written for two teams; the shared state shows the first
+// four players of each. Sizes can only be changed before a match starts.
+#define FIELD(name, type, lo, hi, reload) \
+    { #name, type, offsetof(GameConfig, name), lo, hi, reload }
+
+const ConfigField config_fields[] = {
+    FIELD(num_teams,                 FIELD_INT,    2,     2,       0),
+    FIELD(players_per_team,          FIELD_INT,    1,     1 << 20, 0),
+    FIELD(rope_threshold,            FIELD_DOUBLE, 0.001, 1e9,     1),
+    FIELD(game_duration,             FIELD_INT,    1,     1e7,     0),
+    FIELD(energy_report_interval,    FIELD_INT,    1,     3600,    1),
+    FIELD(fall_recovery_min,         FIELD_INT,    0,     3600,    1),
+    FIELD(fall_recovery_max,         FIELD_INT,    0,     3600,    1),
+    FIELD(fall_probability,          FIELD_FLOAT,  0,     1,       1),
+    FIELD(round_win_threshold,       FIELD_DOUBLE, 0.001, 1e9,     1),
+    FIELD(total_rounds,              FIELD_INT,    1,     1e6,     1),
+    FIELD(consecutive_rounds_to_win, FIELD_INT,    1,     1e6,     1),
+    FIELD(minimum_energy,            FIELD_INT,    0,     1e6,     0),
+    FIELD(range,                     FIELD_INT,    1,     1e6,     0),
+};
+const int config_field_count = sizeof(config_fields) / sizeof(config_fields[0]);
+
+#undef FIELD
+
+// Reload watch state
+static int  watch_fd = -1;
+static char watch_path[512];
+static const char *watch_name = NULL;   // File name part of watch_path
+
+// ---------------------------------------------------------------------
+// Field access
+// ---------------------------------------------------------------------
+const ConfigField *config_find_field(const char *name) {
+    for (int i = 0; i < config_field_count; i++) {
+        if (strcmp(config_fields[i].name, name) == 0)
+            return &config_fields[i];
+    }
+    return NULL;
+}
+
+double config_get_field(const GameConfig *cfg, const ConfigField *field) {
+    const char *base = (const char *)cfg + field->offset;
+    switch (field->type) {
+        case FIELD_INT:    return *(const int *)base;
+        case FIELD_FLOAT:  return *(const float *)base;
+        case FIELD_DOUBLE: return *(const double *)base;
+    }
+    return 0.0;
+}
+
+void config_set_field(GameConfig *cfg, const ConfigField *field, double value) {
+    char *base = (char *)cfg + field->offset;
+    switch (field->type) {
+        case FIELD_INT:    *(int *)base = (int)value; break;
+        case FIELD_FLOAT:  *(float *)base = (float)value; break;
+        case FIELD_DOUBLE: *(double *)base = value; break;
+    }
+}
+
+// ---------------------------------------------------------------------
+// Loading and validation
+// ---------------------------------------------------------------------
+int config_load(const char *config_file, GameConfig *cfg, char *err, size_t err_len) {
     FILE *file = fopen(config_file, "r");
     if (!file) {
-        perror("Error opening config file");
-        exit(EXIT_FAILURE);
+        snprintf(err, err_len, "%s: %s", config_file, strerror(errno));
+        return -1;
     }
     char line[128];
+    int line_no = 0;
     while (fgets(line, sizeof(line), file) != NULL) {
+        line_no++;
         // Skip comments and blank lines
-        if (line[0] == '#' || line[0] == '\n')
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
             continue;
         char key[64], value[64];
-        if (sscanf(line, "%63[^=]=%63s", key, value) == 2) {
-            if (strcmp(key, "num_teams") == 0)
-                config.num_teams = atoi(value);
-            else if (strcmp(key, "players_per_team") == 0)
-                config.players_per_team = atoi(value);
-            else if (strcmp(key, "rope_threshold") == 0)
-                config.rope_threshold = atof(value);
-            else if (strcmp(key, "game_duration") == 0)
-                config.game_duration = atoi(value);
-            else if (strcmp(key, "energy_report_interval") == 0)
-                config.energy_report_interval = atoi(value);
-            else if (strcmp(key, "fall_recovery_min") == 0)
-                config.fall_recovery_min = atoi(value);
-            else if (strcmp(key, "fall_recovery_max") == 0)
-                config.fall_recovery_max = atoi(value);
-            else if (strcmp(key, "fall_probability") == 0)
-                config.fall_probability = atof(value);
-            else if (strcmp(key, "round_win_threshold") == 0)
-                config.round_win_threshold = atof(value);
-            else if (strcmp(key, "total_rounds") == 0)
-                config.total_rounds = atoi(value);
-            else if (strcmp(key, "consecutive_rounds_to_win") == 0)
-                config.consecutive_rounds_to_win = atoi(value);
-            else if (strcmp(key, "minimum_energy") == 0)
-                config.minimum_energy = atoi(value);
-            else if (strcmp(key, "range") == 0)
-                config.range = atoi(value);
+        if (sscanf(line, " %63[^= \t] = %63s", key, value) != 2) {
+            snprintf(err, err_len, "%s:%d: expected key=value", config_file, line_no);
+            fclose(file);
+            return -1;
         }
+        const ConfigField *field = config_find_field(key);
+        if (!field) {
+            snprintf(err, err_len, "%s:%d: unknown key '%s'", config_file, line_no, key);
+            fclose(file);
+            return -1;
+        }
+        char *end;
+        double v = strtod(value, &end);
+        if (end == value || *end != '\0' ||
+            (field->type == FIELD_INT && v != (double)(long)v)) {
+            snprintf(err, err_len, "%s:%d: bad value '%s' for %s",
+                     config_file, line_no, value, key);
+            fclose(file);
+            return -1;
+        }
+        config_set_field(cfg, field, v);
     }
     fclose(file);
+    return 0;
+}
+
+int config_validate(const GameConfig *cfg, char *err, size_t err_len) {
+    for (int i = 0; i < config_field_count; i++) {
+        const ConfigField *f = &config_fields[i];
+        double v = config_get_field(cfg, f);
+        if (v < f->min || v > f->max) {
+            snprintf(err, err_len, "%s=%g is outside [%g, %g]", f->name, v, f->min, f->max);
+            return -1;
+        }
+    }
+    if (cfg->fall_recovery_max < cfg->fall_recovery_min) {
+        snprintf(err, err_len, "fall_recovery_max (%d) is below fall_recovery_min (%d)",
+                 cfg->fall_recovery_max, cfg->fall_recovery_min);
+        return -1;
+    }
+    if (cfg->round_win_threshold > cfg->rope_threshold) {
+        snprintf(err, err_len, "round_win_threshold (%g) can never be reached with "
+                 "rope_threshold %g", cfg->round_win_threshold, cfg->rope_threshold);
+        return -1;
+    }
+    return 0;
+}
+
+void initialize_config(const char *config_file) {
+    GameConfig loaded = config;
+    char err[256];
+    if (config_load(config_file, &loaded, err, sizeof(err)) != 0 ||
+        config_validate(&loaded, err, sizeof(err)) != 0) {
+        fprintf(stderr, "Error in config file: %s\n", err);
+        exit(EXIT_FAILURE);
+    }
+    config = loaded;
+}
+
+// ---------------------------------------------------------------------
+// Hot reload
+// ---------------------------------------------------------------------
+int config_watch_start(const char *config_file) {
+    snprintf(watch_path, sizeof(watch_path), "%s", config_file);
+
+    // Watch the directory: editors often replace the file by renaming
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", config_file);
+    char *slash = strrchr(dir, '/');
+    if (slash) {
+        *slash = '\0';
+        watch_name = watch_path + (slash - dir) + 1;
+    } else {
+        snprintf(dir, sizeof(dir), ".");
+        watch_name = watch_path;
+    }
+
+    watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd < 0) {
+        perror("inotify_init1");
+        return -1;
+    }
+    if (inotify_add_watch(watch_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        perror("inotify_add_watch");
+        close(watch_fd);
+        watch_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int config_poll_reload(void) {
+    if (watch_fd < 0)
+        return 0;
+
+    // Drain pending events and see whether any of them is our file
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int changed = 0;
+    ssize_t n;
+    while ((n = read(watch_fd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            if (ev->len > 0 && strcmp(ev->name, watch_name) == 0)
+                changed = 1;
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+    if (!changed)
+        return 0;
+
+    char err[256];
+    GameConfig loaded = config;
+    if (config_load(watch_path, &loaded, err, sizeof(err)) != 0 ||
+        config_validate(&loaded, err, sizeof(err)) != 0) {
+        LOG_WARN("Config reload rejected, keeping current settings: %s\n", err);
+        return 0;
+    }
+
+    // Fields that size or schedule the match keep their current values
+    for (int i = 0; i < config_field_count; i++) {
+        const ConfigField *f = &config_fields[i];
+        if (!f->reloadable && config_get_field(&loaded, f) != config_get_field(&config, f)) {
+            LOG_WARN("Config reload: %s cannot change during a match, ignored\n", f->name);
+            config_set_field(&loaded, f, config_get_field(&config, f));
+        }
+    }
+    config = loaded;
+    LOG_INFO("Config reloaded from %s\n", watch_path);
+    return 1;
+}
+
+void config_watch_stop(void) {
+    if (watch_fd >= 0) {
+        close(watch_fd);
+        watch_fd = -1;
+    }
 }
@@ -2,6 +2,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <stddef.h>
+
 typedef struct {
     int num_teams;
     int players_per_team;
@@ -20,7 +22,46 @@ typedef struct {
 
 extern GameConfig config;
 
+// ----------------------------------------------------------
+// Field table: one entry per config.txt key, with its storage type,
+// location inside GameConfig, allowed range and whether it may change
+// while a match is running.
+// ----------------------------------------------------------
+typedef enum {
+    FIELD_INT,
+    FIELD_FLOAT,
+    FIELD_DOUBLE
+} ConfigFieldType;
+
+typedef struct {
+    const char     *name;
+    ConfigFieldType type;
+    size_t          offset;
+    double          min;
+    double          max;
+    int             reloadable;
+} ConfigField;
+
+extern const ConfigField config_fields[];
+extern const int config_field_count;
+
+const ConfigField *config_find_field(const char *name);
+double config_get_field(const GameConfig *cfg, const ConfigField *field);
+void   config_set_field(GameConfig *cfg, const ConfigField *field, double value);
+
 // Function to initialize the configuration from a file.
+// Exits with a message if the file is missing or invalid.
 void initialize_config(const char *config_file);
 
+// Parse a file on top of *cfg; returns 0 on success, -1 with a message in err
+int config_load(const char *config_file, GameConfig *cfg, char *err, size_t err_len);
+// Check ranges and cross-field rules; returns 0 if usable, -1 with a message
+int config_validate(const GameConfig *cfg, char *err, size_t err_len);
+
+// Watch the file for edits (inotify). config_poll_reload never blocks; it
+// returns 1 when a new, valid configuration has been copied into config.
+int  config_watch_start(const char *config_file);
+int  config_poll_reload(void);
+void config_watch_stop(void);
+
 #endif  // CONFIG_H
@@ -0,0 +1,393 @@
+// Columnar per-tick export (see export.h)
+#define _POSIX_C_SOURCE 200809L
+
+#include "export.h"
+#include "game.h"
+#include "cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// Chunks in flight: one being filled, the rest queued for the writer
+#define EXPORT_BUFFERS 3
+
+// Target size of one chunk's raw values (the row count follows from it)
+#define EXPORT_CHUNK_BYTES (1 << 20)
+#define EXPORT_MIN_ROWS    64
+#define EXPORT_MAX_ROWS    4096
+
+#define EXPORT_INT_COLUMNS 3    // match, tick, round
+
+typedef struct {
+    char name[32];
+    int  type;
+    int  encoding;
+    int  index;                 // Column within the chunk array of its type
+} ExportColumn;
+
+typedef struct {
+    int      rows;
+    int64_t *ints;              // [column][row] for every array
+    float   *floats;
+    uint8_t *flags;
+} ExportChunk;
+
+int export_active = 0;
+
+static FILE *file = NULL;
+static int   ncolumns = 0;
+static ExportColumn *columns = NULL;
+static int   players = 0;       // Exported players per team
+static int   nfloats = 0;
+static int   nflags = 0;
+static int   chunk_rows = 0;
+static long  match_id = 0;
+static int   write_failed = 0;
+static int   atfork_registered = 0;
+
+// Chunks [tail, head) are queued; chunks[head % EXPORT_BUFFERS] is filling
+static ExportChunk chunks[EXPORT_BUFFERS];
+static unsigned head = 0;
+static unsigned tail = 0;
+static int stop = 0;
+static pthread_t writer;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t drained = PTHREAD_COND_INITIALIZER;
+
+// Encoder output, reused for every column
+static uint8_t *scratch = NULL;
+static size_t scratch_cap = 0;
+
+// ---------------------------------------------------------------------
+// Encoding (writer thread)
+// ---------------------------------------------------------------------
+static int reserve(size_t bytes) {
+    if (bytes <= scratch_cap)
+        return 0;
+    size_t cap = scratch_cap ? scratch_cap : 4096;
+    while (cap < bytes)
+        cap *= 2;
+    uint8_t *p = realloc(scratch, cap);
+    if (!p)
+        return -1;
+    scratch = p;
+    scratch_cap = cap;
+    return 0;
+}
+
+// Runs of equal deltas: u32 runs, u32 counts[runs], i64 deltas[runs]
+static size_t encode_delta_rle(const int64_t *v, int rows) {
+    if (reserve(4 + (size_t)rows * 12) != 0)
+        return 0;
+    uint32_t *counts = (uint32_t *)(scratch + 4);
+    int64_t *deltas = malloc((size_t)rows * sizeof(int64_t));
+    if (!deltas)
+        return 0;
+    uint32_t runs = 0;
+    int64_t prev = 0;
+    for (int r = 0; r < rows; r++) {
+        int64_t d = v[r] - prev;
+        prev = v[r];
+        if (runs > 0 && deltas[runs - 1] == d) {
+            counts[runs - 1]++;
+        } else {
+            deltas[runs] = d;
+            counts[runs++] = 1;
+        }
+    }
+    memcpy(scratch, &runs, 4);
+    memcpy(scratch + 4 + (size_t)runs * 4, deltas, (size_t)runs * 8);
+    free(deltas);
+    return 4 + (size_t)runs * 12;
+}
+
+// Runs of equal flags: u32 runs, u32 counts[runs], u8 values[runs]
+static size_t encode_rle(const uint8_t *v, int rows) {
+    if (reserve(4 + (size_t)rows * 5) != 0)
+        return 0;
+    uint32_t *counts = (uint32_t *)(scratch + 4);
+    uint8_t *values = scratch + 4 + (size_t)rows * 4;  // Moved down below
+    uint32_t runs = 0;
+    for (int r = 0; r < rows; r++) {
+        if (runs > 0 && values[runs - 1] == v[r]) {
+            counts[runs - 1]++;
+        } else {
+            values[runs] = v[r];
+            counts[runs++] = 1;
+        }
+    }
+    memcpy(scratch, &runs, 4);
+    memmove(scratch + 4 + (size_t)runs * 4, values, runs);
+    return 4 + (size_t)runs * 5;
+}
+
+static size_t encode_raw(const float *v, int rows) {
+    if (reserve((size_t)rows * 4) != 0)
+        return 0;
+    memcpy(scratch, v, (size_t)rows * 4);
+    return (size_t)rows * 4;
+}
+
+static size_t encode_column(const ExportChunk *c, const ExportColumn *col) {
+    size_t offset = (size_t)col->index * chunk_rows;
+    switch (col->encoding) {
+        case EXPORT_ENC_DELTA_RLE: return encode_delta_rle(c->ints + offset, c->rows);
+        case EXPORT_ENC_RLE:       return encode_rle(c->flags + offset, c->rows);
+        default:                   return encode_raw(c->floats + offset, c->rows);
+    }
+}
+
+// The chunk header holds its byte count, which is only known once every
+// column is encoded: reserve it and patch it afterwards
+static int write_chunk(const ExportChunk *c) {
+    uint32_t hdr[2] = { (uint32_t)c->rows, 0 };
+    long start = ftell(file);
+    if (fwrite(hdr, sizeof(hdr), 1, file) != 1)
+        return -1;
+    for (int i = 0; i < ncolumns; i++) {
+        size_t len = encode_column(c, &columns[i]);
+        if (len == 0)
+            return -1;
+        uint32_t len32 = (uint32_t)len;
+        if (fwrite(&len32, 4, 1, file) != 1 || fwrite(scratch, 1, len, file) != len)
+            return -1;
+        hdr[1] += 4 + len32;
+    }
+    long end = ftell(file);
+    if (fseek(file, start + 4, SEEK_SET) != 0 || fwrite(&hdr[1], 4, 1, file) != 1 ||
+        fseek(file, end, SEEK_SET) != 0)
+        return -1;
+    return 0;
+}
+
+static void *writer_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (head == tail && !stop)
+            pthread_cond_wait(&ready, &lock);
+        if (head == tail)
+            break;  // Stopped and drained
+        ExportChunk *c = &chunks[tail % EXPORT_BUFFERS];
+        pthread_mutex_unlock(&lock);
+
+        if (!write_failed && write_chunk(c) != 0)
+            write_failed = 1;
+
+        pthread_mutex_lock(&lock);
+        c->rows = 0;
+        tail++;
+        pthread_cond_signal(&drained);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------
+// Producer side (referee)
+// ---------------------------------------------------------------------
+
+// Queue the filling chunk and wait until the next one is free
+static void submit_chunk(void) {
+    pthread_mutex_lock(&lock);
+    head++;
+    pthread_cond_signal(&ready);
+    while (head - tail >= EXPORT_BUFFERS)
+        pthread_cond_wait(&drained, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+void export_set_match(long id) {
+    match_id = id;
+}
+
+void export_tick(void) {
+    ExportChunk *c = &chunks[head % EXPORT_BUFFERS];
+    size_t r = (size_t)c->rows;
+    size_t n = (size_t)chunk_rows;
+
+    c->ints[0 * n + r] = match_id;
+    c->ints[1 * n + r] = sim_ticks;
+    c->ints[2 * n + r] = round_number;
+    c->floats[0 * n + r] = rope_position;
+    c->floats[1 * n + r] = team_efforts[0];
+    c->floats[2 * n + r] = team_efforts[1];
+
+    // Per player: energy and effort, then the recovering flag
+    size_t f = 3, g = 0;
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        const Player *team = teams[t];
+        for (int p = 0; p < players; p++) {
+            c->floats[f++ * n + r] = team[p].energy;
+            c->floats[f++ * n + r] = team[p].effort;
+            c->flags[g++ * n + r] = (uint8_t)(team[p].recovering != 0);
+        }
+    }
+
+    if (++c->rows == chunk_rows)
+        submit_chunk();
+}
+
+// ---------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------
+
+// Children inherit the open file but not the writer thread
+static void atfork_child(void) {
+    export_active = 0;
+    file = NULL;
+}
+
+static void add_column(const char *name, int type, int encoding, int index) {
+    ExportColumn *col = &columns[ncolumns++];
+    snprintf(col->name, sizeof(col->name), "%s", name);
+    col->type = type;
+    col->encoding = encoding;
+    col->index = index;
+}
+
+static int write_header(void) {
+    char meta[2048];
+    uint32_t meta_len = (uint32_t)cache_canonical_key(&config, meta, sizeof(meta));
+    uint32_t version = EXPORT_FORMAT_VERSION, count = (uint32_t)ncolumns;
+    if (fwrite(EXPORT_MAGIC, 8, 1, file) != 1 || fwrite(&version, 4, 1, file) != 1 ||
+        fwrite(&count, 4, 1, file) != 1 || fwrite(&meta_len, 4, 1, file) != 1 ||
+        fwrite(meta, 1, meta_len, file) != meta_len)
+        return -1;
+    for (int i = 0; i < ncolumns; i++) {
+        uint8_t type = (uint8_t)columns[i].type, enc = (uint8_t)columns[i].encoding;
+        uint16_t len = (uint16_t)strlen(columns[i].name);
+        if (fwrite(&type, 1, 1, file) != 1 || fwrite(&enc, 1, 1, file) != 1 ||
+            fwrite(&len, 2, 1, file) != 1 || fwrite(columns[i].name, 1, len, file) != len)
+            return -1;
+    }
+    return 0;
+}
+
+static void free_buffers(void) {
+    for (int b = 0; b < EXPORT_BUFFERS; b++) {
+        free(chunks[b].ints);
+        free(chunks[b].floats);
+        free(chunks[b].flags);
+        memset(&chunks[b], 0, sizeof(chunks[b]));
+    }
+    free(columns);
+    columns = NULL;
+    free(scratch);
+    scratch = NULL;
+    scratch_cap = 0;
+}
+
+int export_open(const char *path) {
+    if (export_active)
+        export_close();
+    if (!atfork_registered) {
+        pthread_atfork(NULL, NULL, atfork_child);
+        atfork_registered = 1;
+    }
+
+    players = config.players_per_team < EXPORT_MAX_PLAYERS
+            ? config.players_per_team : EXPORT_MAX_PLAYERS;
+    if (players < config.players_per_team)
+        fprintf(stderr, "Export: only the first %d players of each team get columns\n",
+                EXPORT_MAX_PLAYERS);
+    nfloats = 3 + NUM_TEAMS * players * 2;
+    nflags = NUM_TEAMS * players;
+
+    size_t row_bytes = EXPORT_INT_COLUMNS * 8 + (size_t)nfloats * 4 + (size_t)nflags;
+    chunk_rows = (int)(EXPORT_CHUNK_BYTES / row_bytes);
+    if (chunk_rows < EXPORT_MIN_ROWS)
+        chunk_rows = EXPORT_MIN_ROWS;
+    if (chunk_rows > EXPORT_MAX_ROWS)
+        chunk_rows = EXPORT_MAX_ROWS;
+
+    // Column table, in file order
+    ncolumns = 0;
+    columns = malloc((size_t)(EXPORT_INT_COLUMNS + nfloats + nflags) * sizeof(ExportColumn));
+    if (!columns) {
+        perror("Export setup failed");
+        return -1;
+    }
+    add_column("match", EXPORT_TYPE_I64, EXPORT_ENC_DELTA_RLE, 0);
+    add_column("tick", EXPORT_TYPE_I64, EXPORT_ENC_DELTA_RLE, 1);
+    add_column("round", EXPORT_TYPE_I64, EXPORT_ENC_DELTA_RLE, 2);
+    add_column("rope_position", EXPORT_TYPE_F32, EXPORT_ENC_RAW, 0);
+    add_column("effort_team1", EXPORT_TYPE_F32, EXPORT_ENC_RAW, 1);
+    add_column("effort_team2", EXPORT_TYPE_F32, EXPORT_ENC_RAW, 2);
+    int f = 3, g = 0;
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        for (int p = 0; p < players; p++) {
+            char name[32];
+            snprintf(name, sizeof(name), "energy_t%d_p%d", t + 1, p + 1);
+            add_column(name, EXPORT_TYPE_F32, EXPORT_ENC_RAW, f++);
+            snprintf(name, sizeof(name), "effort_t%d_p%d", t + 1, p + 1);
+            add_column(name, EXPORT_TYPE_F32, EXPORT_ENC_RAW, f++);
+            snprintf(name, sizeof(name), "recovering_t%d_p%d", t + 1, p + 1);
+            add_column(name, EXPORT_TYPE_U8, EXPORT_ENC_RLE, g++);
+        }
+    }
+
+    for (int b = 0; b < EXPORT_BUFFERS; b++) {
+        chunks[b].rows = 0;
+        chunks[b].ints = malloc((size_t)EXPORT_INT_COLUMNS * chunk_rows * sizeof(int64_t));
+        chunks[b].floats = malloc((size_t)nfloats * chunk_rows * sizeof(float));
+        chunks[b].flags = malloc((size_t)nflags * chunk_rows);
+        if (!chunks[b].ints || !chunks[b].floats || !chunks[b].flags) {
+            perror("Export setup failed");
+            free_buffers();
+            return -1;
+        }
+    }
+
+    file = fopen(path, "wb");
+    if (!file || write_header() != 0) {
+        fprintf(stderr, "Cannot write export file %s: %s\n", path, strerror(errno));
+        if (file)
+            fclose(file);
+        file = NULL;
+        free_buffers();
+        return -1;
+    }
+
+    head = tail = 0;
+    stop = 0;
+    write_failed = 0;
+    match_id = 0;
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        perror("export writer");
+        fclose(file);
+        file = NULL;
+        free_buffers();
+        return -1;
+    }
+    export_active = 1;
+    return 0;
+}
+
+int export_close(void) {
+    if (!export_active)
+        return 0;
+    export_active = 0;
+
+    // Hand over the partial chunk, then let the writer drain and exit
+    pthread_mutex_lock(&lock);
+    if (chunks[head % EXPORT_BUFFERS].rows > 0)
+        head++;
+    stop = 1;
+    pthread_cond_signal(&ready);
+    pthread_mutex_unlock(&lock);
+    pthread_join(writer, NULL);
+
+    int status = write_failed ? -1 : 0;
+    if (fclose(file) != 0)
+        status = -1;
+    file = NULL;
+    free_buffers();
+    if (status != 0)
+        fprintf(stderr, "Export: not every chunk could be written\n");
+    return status;
+}
@@ -0,0 +1,60 @@
+// export.h
+#ifndef EXPORT_H
+#define EXPORT_H
+
+// ----------------------------------------------------------
+// Columnar per-tick export. Every tick the referee appends one row (match
+// id, tick, round, rope position, team efforts and each player's energy,
+// effort and recovering flag) to an in-memory column chunk; full chunks
+// are encoded and written by a background thread, so the tick loop only
+// stores a few numbers.
+//
+// File layout (little-endian):
+//   "TUGCOL\0\0", u32 version, u32 columns, u32 meta length, meta text
+//   (the canonical config, see cache_canonical_key), then per column
+//   u8 type, u8 encoding, u16 name length, name.
+//   Then chunks until end of file: u32 rows, u32 bytes that follow, and
+//   per column u32 length and the encoded values.
+// Encodings: raw (f32 columns), delta-RLE (i64 columns: u32 runs,
+// u32 counts[runs], i64 deltas[runs]; the first delta is from 0) and
+// RLE (u8 flags: u32 runs, u32 counts[runs], u8 values[runs]). Every
+// chunk decodes on its own. tools/tugcol.py loads files into pandas.
+//
+// Only the first EXPORT_MAX_PLAYERS players of each team get columns.
+// ----------------------------------------------------------
+
+#define EXPORT_MAGIC          "TUGCOL\0\0"
+#define EXPORT_FORMAT_VERSION 1
+#define EXPORT_MAX_PLAYERS    256
+
+enum {
+    EXPORT_TYPE_I64 = 0,
+    EXPORT_TYPE_F32 = 1,
+    EXPORT_TYPE_U8  = 2
+};
+
+enum {
+    EXPORT_ENC_RAW       = 0,
+    EXPORT_ENC_DELTA_RLE = 1,
+    EXPORT_ENC_RLE       = 2
+};
+
+// Set while a file is open in this process; the referee tests it before
+// calling export_tick. Forked children start with it cleared.
+extern int export_active;
+
+// Create path for the current config's roster and start the writer thread
+int  export_open(const char *path);
+
+// Id stored in the match column from now on (the seed of headless
+// matches, the match number of live ones)
+void export_set_match(long id);
+
+// Append the state after the tick just played
+void export_tick(void);
+
+// Write the last partial chunk, stop the writer and close the file.
+// Returns 0 if everything reached the file.
+int  export_close(void);
+
+#endif  // EXPORT_H
@@ -0,0 +1,115 @@
+// game.h
+#ifndef GAME_H
+#define GAME_H
+
+#include <time.h>
+#include <sys/types.h>
+#include "config.h"
+#include "state.h"      // Player and SharedState layouts
+
+// Bump whenever a change alters the outcome of a seeded headless match;
+// cached results (cache.c) from other engine versions are then ignored
+#define ENGINE_VERSION 4
+
+// Simulation tick configuration
+#define TICKS_PER_SECOND 10         // We divide each real second into 10 ticks
+#define TICK_NSEC 100000000LL       // Game time per tick (100 ms)
+
+// ----------------------------------------------------------
+// Per-tick constants derived from config. Recomputed by
+// derive_tick_params() at start-up and after every config reload, so the
+// tick loops never redo these divisions.
+// ----------------------------------------------------------
+typedef struct {
+    float fall_probability_per_tick;  // fall_probability / TICKS_PER_SECOND
+    float decay_per_tick_scale;       // Multiplies decay_rate: 1 / TICKS_PER_SECOND
+    float rope_step_scale;            // Multiplies effort difference: 0.05 / TICKS_PER_SECOND
+    float rope_threshold;             // Clamp for rope_position
+    int   recovery_span;              // fall_recovery_max - fall_recovery_min + 1
+    int   decay_divisor;              // 1 / decay_per_tick_scale (fixed-point kernel)
+    int   rope_step_divisor;          // 1 / rope_step_scale (fixed-point kernel)
+} TickParams;
+
+extern TickParams tick_params;
+
+// Signals the referee sends player processes (need <signal.h>)
+#define SIG_WIN_ROUND  SIGUSR2      // Notify player/team of round win
+#define SIG_LOSE_ROUND SIGURG       // Notify player/team of round loss
+#define SIG_MATCH_WIN  SIGWINCH     // Match win signal
+#define SIG_MATCH_LOSE SIGIO        // Match loss signal
+
+// Outcome and summary of one headless match
+typedef struct {
+    int   winner;                      // Winning team index, -1 for a tie
+    int   rounds_played;
+    int   round_wins[NUM_TEAMS];
+    long  ticks;
+    float final_rope_position;
+} MatchResult;
+
+// ----------------------------------------------------------
+// Game state owned by the referee (defined in main.c)
+// ----------------------------------------------------------
+extern SharedState *shared_state;
+extern Player **teams;
+extern int   team_round_wins[NUM_TEAMS];
+extern int   team_consecutive_wins[NUM_TEAMS];
+extern float *team_efforts;
+extern float rope_position;
+extern int   game_active;
+extern int   round_number;
+extern int **energy_pipes;
+extern int  *team_order[NUM_TEAMS];
+extern int   team_order_valid[NUM_TEAMS];
+
+// Headless mode: no player processes, no visualizer, no sleeping.
+// The game clock advances by one tick per loop iteration.
+extern int  headless;
+extern long sim_ticks;
+
+// Engine RNG state; everything that decides a match draws from game_rand()
+extern unsigned int game_rng;
+
+// ----------------------------------------------------------
+// Engine entry points
+// ----------------------------------------------------------
+int  map_shared_state(void);
+void allocate_game(void);
+void initialize_game();
+void free_game(void);
+void reset_match_state(void);
+void referee_control();
+int  run_headless_match(unsigned int seed, MatchResult *result);
+int  run_headless_match_rosters(unsigned int seed, const Player *const rosters[NUM_TEAMS],
+                                MatchResult *result);
+int  finish_headless_match(MatchResult *result);
+int  game_elapsed_seconds(void);
+void game_srand(unsigned int seed);
+int  game_rand(void);
+void derive_tick_params(void);
+
+// Player processes
+void setup_signal_handlers();
+void start_players();
+
+// Per-tick steps
+void check_player_falls_partial();
+void recover_players_partial();
+void request_energy_reports_partial();
+void update_rope_position_partial();
+void mirror_to_shared_memory();
+
+// Round handling
+void check_round_winner();
+void notify_round_result(int winning_team);
+void notify_match_result(int winning_team);
+void align_team(int team_index);
+void align_all_teams(void);
+void reset_team_order(void);
+void countdown(int seconds);
+
+// Reporting
+void print_game_status();
+void print_team_stats();
+
+#endif  // GAME_H
@@ -0,0 +1,60 @@
+// Game clock (see game_clock.h)
+#define _POSIX_C_SOURCE 200809L
+
+#include "game_clock.h"
+#include "game.h"
+#include <time.h>
+
+static double  warp = 1.0;
+static int64_t base_game_ns = 0;   // Game time at base_real_ns
+static int64_t base_real_ns = 0;   // CLOCK_MONOTONIC reading at the last (re)start
+
+static int64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+int64_t game_clock_ns(void) {
+    if (headless)
+        return (int64_t)sim_ticks * (NSEC_PER_SEC / TICKS_PER_SECOND);
+    if (base_real_ns == 0)
+        return base_game_ns;  // Not started yet
+    return base_game_ns + (int64_t)((double)(monotonic_ns() - base_real_ns) * warp);
+}
+
+void game_clock_start(int64_t at_ns) {
+    base_game_ns = at_ns;
+    base_real_ns = monotonic_ns();
+}
+
+void game_clock_set_warp(double factor) {
+    if (factor < GAME_CLOCK_WARP_MIN)
+        factor = GAME_CLOCK_WARP_MIN;
+    if (factor > GAME_CLOCK_WARP_MAX)
+        factor = GAME_CLOCK_WARP_MAX;
+    // Rebase so the game time read just before the change carries on
+    int64_t now = game_clock_ns();
+    warp = factor;
+    if (!headless)
+        game_clock_start(now);
+}
+
+double game_clock_warp(void) {
+    return warp;
+}
+
+void game_clock_sleep_until(int64_t at_ns) {
+    if (headless)
+        return;
+    int64_t wait = at_ns - game_clock_ns();
+    if (wait <= 0)
+        return;
+    int64_t real = (int64_t)((double)wait / warp);
+    struct timespec ts = { (time_t)(real / NSEC_PER_SEC), (long)(real % NSEC_PER_SEC) };
+    nanosleep(&ts, NULL);
+}
+
+void game_clock_sleep(int64_t duration_ns) {
+    game_clock_sleep_until(game_clock_ns() + duration_ns);
+}
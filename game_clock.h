@@ -0,0 +1,39 @@
+// game_clock.h
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Game clock: nanoseconds of game time since the match started.
+// Headless matches derive it from sim_ticks; live matches run it off
+// CLOCK_MONOTONIC scaled by a warp factor, so a watched match can play
+// faster (warp > 1) or slower (warp < 1) than real time. Everything that
+// measures game time (recovery, match duration, elapsed-time displays)
+// reads this clock instead of time().
+// ----------------------------------------------------------
+
+#define NSEC_PER_SEC 1000000000LL
+
+// Accepted range for the warp factor
+#define GAME_CLOCK_WARP_MIN 0.01
+#define GAME_CLOCK_WARP_MAX 1000.0
+
+// Current game time in nanoseconds
+int64_t game_clock_ns(void);
+
+// Start the live clock at game time at_ns (0 for a new match)
+void    game_clock_start(int64_t at_ns);
+
+// Change the warp factor without a jump in game time; values outside
+// [GAME_CLOCK_WARP_MIN, GAME_CLOCK_WARP_MAX] are clamped
+void    game_clock_set_warp(double warp);
+double  game_clock_warp(void);
+
+// Sleep until the game clock reaches at_ns (returns at once in headless
+// mode or if that time has passed; a signal may cut the sleep short)
+void    game_clock_sleep_until(int64_t at_ns);
+// Sleep for duration_ns of game time
+void    game_clock_sleep(int64_t duration_ns);
+
+#endif  // GAME_CLOCK_H
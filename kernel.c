@@ -0,0 +1,250 @@
+// Tick kernels (see kernel.h)
+#include "kernel.h"
+#include "config.h"
+#include "game.h"
+#include <stdint.h>
+#include <string.h>
+
+// Q16.16 fixed point
+#define FIXED_SHIFT 16
+#define FIXED_ONE   ((int64_t)1 << FIXED_SHIFT)
+
+// Each kernel is written as per-player steps that are always inlined into
+// the loops generated by DEFINE_KERNEL below: once with config's roster
+// shape (the generic code) and once per common shape with constant bounds
+// and a forced unroll. All variants run the same arithmetic in the same
+// order, so their results are identical.
+#define KERNEL_STEP   static inline __attribute__((always_inline))
+#define KERNEL_UNROLL _Pragma("GCC unroll 16")
+
+// ---------------------------------------------------------------------
+// float: the original single-precision kernel
+// ---------------------------------------------------------------------
+typedef float float_sum_t;
+
+// Decay energy and update effort of an active, non-recovering player.
+// Computed for every player and kept only for live ones, so unrolled
+// loops have no branches.
+KERNEL_STEP void float_energy_step(Player *pl, const TickParams *params) {
+    int live = pl->active && !pl->recovering;
+
+    // First, apply energy decay per tick; never below zero
+    float energy = pl->energy - pl->decay_rate * params->decay_per_tick_scale;
+    if (energy < 0)
+        energy = 0;
+
+    // Set effort as energy multiplied by the player's position
+    float effort = energy * (float)pl->position;
+    pl->energy = live ? energy : pl->energy;
+    pl->effort = live ? effort : pl->effort;
+}
+
+// A player's contribution to the team's total effort
+KERNEL_STEP float float_live_effort(const Player *pl) {
+    return pl->active && !pl->recovering ? pl->effort : 0.0f;
+}
+
+// Store team efforts and move the rope by the effort difference
+KERNEL_STEP void float_move_rope(const float total_effort[NUM_TEAMS], int num_teams) {
+    for (int t = 0; t < num_teams; t++) {
+        team_efforts[t] = total_effort[t];
+    }
+
+    // Determine how much the rope moves this tick based on effort difference
+    float diff = total_effort[0] - total_effort[1];
+    float increment = diff * tick_params.rope_step_scale;
+    rope_position -= increment;
+
+    // Clamp rope position within allowed threshold
+    if (rope_position > tick_params.rope_threshold)
+        rope_position = tick_params.rope_threshold;
+    if (rope_position < -tick_params.rope_threshold)
+        rope_position = -tick_params.rope_threshold;
+}
+
+// ---------------------------------------------------------------------
+// fixed: Q16.16 integers. Conversions in truncate (multiplying by a
+// power of two is exact), conversions out go through double, so both
+// directions are exactly rounded and do not depend on compiler flags.
+// ---------------------------------------------------------------------
+// One player's effort fits in int64 within the config limits (see
+// kernel.h); a team of them does not, so sums are 128-bit
+__extension__ typedef __int128 fixed_sum_t;
+
+static inline int64_t to_fixed(float x) {
+    return (int64_t)((double)x * (double)FIXED_ONE);
+}
+
+static inline float from_fixed(fixed_sum_t q) {
+    return (float)((double)q / (double)FIXED_ONE);
+}
+
+KERNEL_STEP void fixed_energy_step(Player *pl, const TickParams *params) {
+    int live = pl->active && !pl->recovering;
+    int64_t energy = to_fixed(pl->energy) - to_fixed(pl->decay_rate) / params->decay_divisor;
+    if (energy < 0)
+        energy = 0;
+    float effort = from_fixed(energy * pl->position);
+    pl->energy = live ? from_fixed(energy) : pl->energy;
+    pl->effort = live ? effort : pl->effort;
+}
+
+// Integer sums are exact, so the order (and vector width) cannot matter
+KERNEL_STEP int64_t fixed_live_effort(const Player *pl) {
+    return pl->active && !pl->recovering ? to_fixed(pl->effort) : 0;
+}
+
+KERNEL_STEP void fixed_move_rope(const fixed_sum_t total[NUM_TEAMS], int num_teams) {
+    for (int t = 0; t < num_teams; t++) {
+        team_efforts[t] = from_fixed(total[t]);
+    }
+
+    fixed_sum_t rope = to_fixed(rope_position) - (total[0] - total[1]) / tick_params.rope_step_divisor;
+    int64_t limit = to_fixed(tick_params.rope_threshold);
+    if (rope > limit)
+        rope = limit;
+    if (rope < -limit)
+        rope = -limit;
+    rope_position = from_fixed(rope);
+}
+
+// ---------------------------------------------------------------------
+// Generic and shape-specialized entry points
+// ---------------------------------------------------------------------
+#define DEFINE_ENERGY_REPORTS(kind, suffix, num_teams, players, unroll)       \
+    static void kind##_energy_reports##suffix(void) {                         \
+        const TickParams params = tick_params;                                \
+        const int nt = (num_teams), np = (players);                           \
+        for (int t = 0; t < nt; t++) {                                        \
+            Player *row = teams[t];                                           \
+            unroll                                                            \
+            for (int p = 0; p < np; p++)                                      \
+                kind##_energy_step(&row[p], &params);                         \
+        }                                                                     \
+    }
+
+#define DEFINE_ROPE_UPDATE(kind, suffix, num_teams, players, unroll)          \
+    static void kind##_rope_update##suffix(void) {                            \
+        kind##_sum_t total[NUM_TEAMS] = {0, 0};                               \
+        const int nt = (num_teams), np = (players);                           \
+        for (int t = 0; t < nt; t++) {                                        \
+            const Player *row = teams[t];                                     \
+            kind##_sum_t sum = 0;                                             \
+            unroll                                                            \
+            for (int p = 0; p < np; p++)                                      \
+                sum += kind##_live_effort(&row[p]);                           \
+            total[t] = sum;                                                   \
+        }                                                                     \
+        kind##_move_rope(total, nt);                                          \
+    }
+
+#define DEFINE_KERNEL(kind, suffix, num_teams, players, unroll)               \
+    DEFINE_ENERGY_REPORTS(kind, suffix, num_teams, players, unroll)           \
+    DEFINE_ROPE_UPDATE(kind, suffix, num_teams, players, unroll)
+
+// Chunk entry points (generic only: chunked ticks are for large rosters)
+#define DEFINE_CHUNK_KERNEL(kind, field)                                      \
+    static void kind##_energy_chunk(Player *row, int begin, int end) {        \
+        const TickParams params = tick_params;                                \
+        for (int p = begin; p < end; p++)                                     \
+            kind##_energy_step(&row[p], &params);                             \
+    }                                                                         \
+    static KernelSum kind##_effort_chunk(const Player *row, int begin, int end) { \
+        kind##_sum_t sum = 0;                                                 \
+        for (int p = begin; p < end; p++)                                     \
+            sum += kind##_live_effort(&row[p]);                               \
+        KernelSum s;                                                          \
+        s.field = sum;                                                        \
+        return s;                                                             \
+    }                                                                         \
+    static void kind##_rope_reduce(const KernelSum *sums, int chunks) {       \
+        kind##_sum_t total[NUM_TEAMS] = {0, 0};                               \
+        const int nt = config.num_teams;                                      \
+        for (int t = 0; t < nt; t++) {                                        \
+            for (int c = 0; c < chunks; c++)                                  \
+                total[t] += sums[t * chunks + c].field;                       \
+        }                                                                     \
+        kind##_move_rope(total, nt);                                          \
+    }
+
+DEFINE_KERNEL(float, , config.num_teams, config.players_per_team, )
+DEFINE_KERNEL(fixed, , config.num_teams, config.players_per_team, )
+// Only the steps that beat the generic loop in tug_bench's
+// specialized_kernel entries. Unrolled, the float 2x4 rope update and the
+// fixed 2x16 energy step were slower and the fixed 2x8 energy step no
+// faster, so those shapes keep the generic code for that step.
+DEFINE_ENERGY_REPORTS(float, _2x4,  NUM_TEAMS, 4,  KERNEL_UNROLL)
+DEFINE_KERNEL(float, _2x8,  NUM_TEAMS, 8,  KERNEL_UNROLL)
+DEFINE_KERNEL(float, _2x16, NUM_TEAMS, 16, KERNEL_UNROLL)
+DEFINE_KERNEL(fixed, _2x4,  NUM_TEAMS, 4,  KERNEL_UNROLL)
+DEFINE_ROPE_UPDATE(fixed, _2x8,  NUM_TEAMS, 8,  KERNEL_UNROLL)
+DEFINE_ROPE_UPDATE(fixed, _2x16, NUM_TEAMS, 16, KERNEL_UNROLL)
+DEFINE_CHUNK_KERNEL(float, f)
+DEFINE_CHUNK_KERNEL(fixed, q)
+
+// ---------------------------------------------------------------------
+// Registry
+// ---------------------------------------------------------------------
+const TickKernel tick_kernels[] = {
+    { "float", float_energy_reports, float_rope_update,
+      float_energy_chunk, float_effort_chunk, float_rope_reduce },
+    { "fixed", fixed_energy_reports, fixed_rope_update,
+      fixed_energy_chunk, fixed_effort_chunk, fixed_rope_reduce },
+};
+const int tick_kernel_count = sizeof(tick_kernels) / sizeof(tick_kernels[0]);
+
+// Unrolled variants for the common shapes (NUM_TEAMS x players); energy
+// and rope are the suffix of each step's variant (empty: generic)
+#define SPECIALIZATION(kind, base, players, energy, rope)                     \
+    { &tick_kernels[base], players,                                           \
+      { #kind "/2x" #players, kind##_energy_reports##energy,                  \
+        kind##_rope_update##rope,                                             \
+        kind##_energy_chunk, kind##_effort_chunk, kind##_rope_reduce } }
+
+static const struct {
+    const TickKernel *base;
+    int               players;
+    TickKernel        kernel;
+} specializations[] = {
+    SPECIALIZATION(float, 0, 4,  _2x4,  ),
+    SPECIALIZATION(float, 0, 8,  _2x8,  _2x8),
+    SPECIALIZATION(float, 0, 16, _2x16, _2x16),
+    SPECIALIZATION(fixed, 1, 4,  _2x4,  _2x4),
+    SPECIALIZATION(fixed, 1, 8,  ,      _2x8),
+    SPECIALIZATION(fixed, 1, 16, ,      _2x16),
+};
+
+const TickKernel *tick_kernel = &tick_kernels[0];
+
+const TickKernel *tick_kernel_specialize(const TickKernel *kernel, int num_teams, int players) {
+    if (num_teams != NUM_TEAMS)
+        return kernel;
+    for (size_t i = 0; i < sizeof(specializations) / sizeof(specializations[0]); i++) {
+        if (specializations[i].base == kernel && specializations[i].players == players)
+            return &specializations[i].kernel;
+    }
+    return kernel;
+}
+
+const TickKernel *tick_kernel_current(void) {
+    // Re-resolved only when the kernel or the roster shape changes
+    static const TickKernel *bound_base = NULL;
+    static const TickKernel *bound = NULL;
+    static int bound_teams = 0, bound_players = 0;
+    if (tick_kernel != bound_base || config.num_teams != bound_teams ||
+        config.players_per_team != bound_players) {
+        bound_base    = tick_kernel;
+        bound_teams   = config.num_teams;
+        bound_players = config.players_per_team;
+        bound = tick_kernel_specialize(tick_kernel, bound_teams, bound_players);
+    }
+    return bound;
+}
+
+const TickKernel *tick_kernel_find(const char *name) {
+    for (int i = 0; i < tick_kernel_count; i++) {
+        if (strcmp(tick_kernels[i].name, name) == 0)
+            return &tick_kernels[i];
+    }
+    return NULL;
+}
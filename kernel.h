@@ -0,0 +1,79 @@
+// kernel.h
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stdint.h>
+#include "state.h"
+
+// ----------------------------------------------------------
+// Tick kernels: interchangeable implementations of the two arithmetic
+// steps of a tick, request_energy_reports_partial() (decay, effort) and
+// update_rope_position_partial() (team sums, rope). The referee calls
+// whichever tick_kernel points at, through tick_kernel_current(): for the
+// common roster shapes 2x4, 2x8 and 2x16 each kernel also has variants
+// compiled with constant loop bounds (fully unrolled), with results
+// identical to the generic code. A shape only uses the variant of a step
+// where it measured faster than the generic loop (make bench).
+//
+//   float  The original single-precision math. Sums depend on summation
+//          order, so the compiler (contraction, vector width) can change
+//          results.
+//   fixed  Energy, effort and rope in Q16.16 integers (128-bit sums). Every
+//          value stored back into the float fields is an exact function
+//          of integers, so results are bit-identical across compilers,
+//          flags and summation orders.
+//
+// Tolerance: from the same state, one fixed tick differs from one float
+// tick by at most 2^-16 in each player's energy (the decay is truncated
+// to Q16.16), and the rope by 2^-16 plus the float rounding of the float
+// path's sums (about 1e-4 with 4 players per team). The error grows with
+// the ticks: on seeds 1-50 with the default roster and identical falls,
+// 100 ticks stayed within 0.002 in energy and rope, 1200 ticks within
+// 0.02 in energy. A rope that lands within that distance of a win
+// threshold can end a round a tick earlier or later, and from there the
+// two kernels play different matches. Values below 256 are stored
+// exactly in the float fields; larger ones are still rounded
+// deterministically.
+//
+// Range: a player's Q16.16 effort (energy x position) must fit in int64,
+// i.e. energy x players_per_team below 2^47. The config limits keep it
+// there (energy below 2^21 with minimum_energy + range <= 2e6, rosters of
+// at most 2^20), and the team sums cannot overflow.
+// ----------------------------------------------------------
+
+// Partial team effort of one chunk of players, in the kernel's sum type
+typedef union {
+    float   f;                       // float
+    __extension__ __int128 q;        // fixed (Q16.16)
+} KernelSum;
+
+typedef struct {
+    const char *name;
+    void (*energy_reports)(void);    // request_energy_reports_partial
+    void (*rope_update)(void);       // update_rope_position_partial
+
+    // The same steps over players [begin, end) of one team, for chunked
+    // ticks (tick_pool.h). rope_reduce adds the chunk sums of each team
+    // in chunk order (sums[t * chunks + c]) and moves the rope.
+    void      (*energy_chunk)(Player *row, int begin, int end);
+    KernelSum (*effort_chunk)(const Player *row, int begin, int end);
+    void      (*rope_reduce)(const KernelSum *sums, int chunks);
+} TickKernel;
+
+extern const TickKernel tick_kernels[];
+extern const int tick_kernel_count;
+
+// The kernel the referee runs (default: float)
+extern const TickKernel *tick_kernel;
+
+// Look a kernel up by name; NULL if unknown
+const TickKernel *tick_kernel_find(const char *name);
+
+// The variant of kernel specialized for num_teams x players, or kernel
+// itself when there is none
+const TickKernel *tick_kernel_specialize(const TickKernel *kernel, int num_teams, int players);
+
+// tick_kernel specialized for the current config (what the tick runs)
+const TickKernel *tick_kernel_current(void);
+
+#endif  // KERNEL_H
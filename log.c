@@ -0,0 +1,377 @@
+// Asynchronous ring-buffer logger (see log.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+// Ring capacity in records (power of two)
+#define LOG_RING_SIZE 4096
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+#define LOG_MAX_ARGS  8
+// Bytes of %s text one record holds (all its strings together)
+#define LOG_STR_BYTES 256
+
+// How long the flusher sleeps when the ring is empty
+#define LOG_FLUSH_INTERVAL_NSEC 10000000L
+
+// Argument kinds, as parsed from the format string
+enum {
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_SIZE,
+    ARG_DOUBLE,
+    ARG_STR,
+    ARG_PTR
+};
+
+typedef union {
+    long long   i;
+    double      d;
+    const char *s;
+    void       *p;
+} LogArg;
+
+typedef struct {
+    unsigned long seq;            // Slot sequence minus slot index (0 = free, lap 0)
+    const char   *fmt;
+    unsigned char level;
+    unsigned char nargs;
+    unsigned char kinds[LOG_MAX_ARGS];
+    LogArg        args[LOG_MAX_ARGS];
+    char          strs[LOG_STR_BYTES];  // Copies of the %s arguments
+} LogRecord;
+
+volatile int log_level = LOG_LEVEL_INFO;
+
+static LogRecord ring[LOG_RING_SIZE];
+static unsigned long ring_head = 0;     // Next slot to claim (producers)
+static unsigned long ring_tail = 0;     // Next slot to flush (flusher only)
+
+static unsigned long dropped_full = 0;  // Records lost because the ring was full
+static unsigned long dropped_rate = 0;  // Records lost to the rate limit
+
+static int  rate_limit = 0;             // Records per second, 0 = unlimited
+static long rate_window = 0;            // Second the counter below belongs to
+static int  rate_count = 0;
+
+static pthread_t flusher;
+static pid_t flusher_pid = 0;           // Process that owns the running flusher
+static volatile int flusher_stop = 0;
+static int atexit_registered = 0;
+
+// ---------------------------------------------------------------------
+// Format string parsing shared by producers and the flusher.
+// Returns a pointer just past the conversion starting at p (p points at
+// '%'), and stores the argument kind (-1 for "%%").
+// ---------------------------------------------------------------------
+static const char *parse_spec(const char *p, int *kind) {
+    p++;
+    if (*p == '%') {
+        *kind = -1;
+        return p + 1;
+    }
+    while (*p && strchr("-+ #0123456789.", *p))
+        p++;
+
+    int length = 0;  // 0 = none, 1 = l, 2 = ll, 3 = z
+    if (*p == 'l') {
+        length = 1;
+        p++;
+        if (*p == 'l') {
+            length = 2;
+            p++;
+        }
+    } else if (*p == 'z') {
+        length = 3;
+        p++;
+    } else if (*p == 'h') {
+        while (*p == 'h')
+            p++;
+    }
+
+    switch (*p) {
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            *kind = ARG_DOUBLE;
+            break;
+        case 's':
+            *kind = ARG_STR;
+            break;
+        case 'p':
+            *kind = ARG_PTR;
+            break;
+        default:  // d i u x X o c
+            *kind = length == 1 ? ARG_LONG : length == 2 ? ARG_LLONG :
+                    length == 3 ? ARG_SIZE : ARG_INT;
+            break;
+    }
+    return *p ? p + 1 : p;
+}
+
+// ---------------------------------------------------------------------
+// Producer side
+// ---------------------------------------------------------------------
+static int rate_limited(void) {
+    if (rate_limit <= 0)
+        return 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    long window = (long)ts.tv_sec;
+    long current = __atomic_load_n(&rate_window, __ATOMIC_RELAXED);
+    if (window != current &&
+        __atomic_compare_exchange_n(&rate_window, &current, window, 0,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&rate_count, 0, __ATOMIC_RELAXED);
+    }
+    return __atomic_add_fetch(&rate_count, 1, __ATOMIC_RELAXED) > rate_limit;
+}
+
+// Copy a %s argument into the record, truncated to the space left (a
+// plain loop: strlen and friends are not async-signal-safe everywhere)
+static const char *copy_str(LogRecord *rec, size_t *used, const char *s) {
+    if (!s)
+        return NULL;
+    char *dst = rec->strs + *used;
+    size_t room = LOG_STR_BYTES - *used;
+    size_t len = 0;
+    while (len + 1 < room && s[len]) {
+        dst[len] = s[len];
+        len++;
+    }
+    dst[len] = '\0';
+    *used += len + 1 < room ? len + 1 : room - 1;
+    return dst;
+}
+
+void log_write(LogLevel level, const char *fmt, ...) {
+    if ((int)level < log_level)
+        return;
+    if (level < LOG_LEVEL_ERROR && rate_limited()) {
+        __atomic_add_fetch(&dropped_rate, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    // Claim a slot (bounded MPMC queue: a slot is free when seq == pos)
+    unsigned long pos = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+    LogRecord *rec;
+    for (;;) {
+        rec = &ring[pos & LOG_RING_MASK];
+        unsigned long seq = __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE)
+                          + (pos & LOG_RING_MASK);
+        long diff = (long)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring_head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        } else if (diff < 0) {
+            // Ring full: never block the caller
+            __atomic_add_fetch(&dropped_full, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Copy the raw arguments; formatting happens in the flusher
+    rec->fmt = fmt;
+    rec->level = (unsigned char)level;
+    int n = 0;
+    size_t str_used = 0;
+    va_list ap;
+    va_start(ap, fmt);
+    for (const char *p = fmt; *p && n < LOG_MAX_ARGS; ) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        int kind;
+        p = parse_spec(p, &kind);
+        switch (kind) {
+            case -1:         continue;
+            case ARG_INT:    rec->args[n].i = va_arg(ap, int); break;
+            case ARG_LONG:   rec->args[n].i = va_arg(ap, long); break;
+            case ARG_LLONG:  rec->args[n].i = va_arg(ap, long long); break;
+            case ARG_SIZE:   rec->args[n].i = (long long)va_arg(ap, size_t); break;
+            case ARG_DOUBLE: rec->args[n].d = va_arg(ap, double); break;
+            case ARG_STR:    rec->args[n].s = copy_str(rec, &str_used, va_arg(ap, const char *)); break;
+            case ARG_PTR:    rec->args[n].p = va_arg(ap, void *); break;
+        }
+        rec->kinds[n++] = (unsigned char)kind;
+    }
+    va_end(ap);
+    rec->nargs = (unsigned char)n;
+
+    // Publish the slot to the flusher
+    __atomic_store_n(&rec->seq, pos + 1 - (pos & LOG_RING_MASK), __ATOMIC_RELEASE);
+}
+
+// ---------------------------------------------------------------------
+// Flusher side
+// ---------------------------------------------------------------------
+static size_t format_record(const LogRecord *rec, char *out, size_t cap) {
+    size_t len = 0;
+    int n = 0;
+    const char *p = rec->fmt;
+    while (*p && len + 1 < cap) {
+        if (*p != '%') {
+            out[len++] = *p++;
+            continue;
+        }
+        int kind;
+        const char *end = parse_spec(p, &kind);
+        if (kind == -1) {
+            out[len++] = '%';
+            p = end;
+            continue;
+        }
+        char spec[32];
+        size_t spec_len = (size_t)(end - p);
+        if (spec_len >= sizeof(spec) || n >= rec->nargs)
+            break;
+        memcpy(spec, p, spec_len);
+        spec[spec_len] = '\0';
+
+        const LogArg *a = &rec->args[n++];
+        int w = 0;
+        switch (kind) {
+            case ARG_INT:    w = snprintf(out + len, cap - len, spec, (int)a->i); break;
+            case ARG_LONG:   w = snprintf(out + len, cap - len, spec, (long)a->i); break;
+            case ARG_LLONG:  w = snprintf(out + len, cap - len, spec, a->i); break;
+            case ARG_SIZE:   w = snprintf(out + len, cap - len, spec, (size_t)a->i); break;
+            case ARG_DOUBLE: w = snprintf(out + len, cap - len, spec, a->d); break;
+            case ARG_STR:    w = snprintf(out + len, cap - len, spec, a->s ? a->s : "(null)"); break;
+            case ARG_PTR:    w = snprintf(out + len, cap - len, spec, a->p); break;
+        }
+        if (w < 0)
+            break;
+        len += (size_t)w < cap - len ? (size_t)w : cap - len - 1;
+        p = end;
+    }
+    return len;
+}
+
+static void write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(STDOUT_FILENO, buf, len);
+        if (w <= 0)
+            return;
+        buf += w;
+        len -= (size_t)w;
+    }
+}
+
+// Flush every published record; returns how many were written
+static int drain(void) {
+    static char buf[16384];
+    size_t used = 0;
+    int count = 0;
+
+    for (;;) {
+        unsigned long slot = ring_tail & LOG_RING_MASK;
+        LogRecord *rec = &ring[slot];
+        unsigned long seq = __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) + slot;
+        if (seq != ring_tail + 1)
+            break;  // Not published yet
+
+        if (sizeof(buf) - used < 1024) {
+            write_all(buf, used);
+            used = 0;
+        }
+        used += format_record(rec, buf + used, sizeof(buf) - used);
+
+        // Hand the slot back to producers for the next lap
+        __atomic_store_n(&rec->seq, ring_tail + LOG_RING_SIZE - slot, __ATOMIC_RELEASE);
+        ring_tail++;
+        count++;
+    }
+
+    unsigned long full = __atomic_exchange_n(&dropped_full, 0, __ATOMIC_RELAXED);
+    unsigned long rate = __atomic_exchange_n(&dropped_rate, 0, __ATOMIC_RELAXED);
+    if (full || rate) {
+        if (sizeof(buf) - used < 128) {
+            write_all(buf, used);
+            used = 0;
+        }
+        int w = snprintf(buf + used, sizeof(buf) - used,
+                         "[log] dropped %lu records (ring full), %lu (rate limit)\n",
+                         full, rate);
+        if (w > 0)
+            used += (size_t)w < sizeof(buf) - used ? (size_t)w : sizeof(buf) - used - 1;
+    }
+    write_all(buf, used);
+    return count;
+}
+
+static void *flusher_main(void *arg) {
+    (void)arg;
+    struct timespec interval = { 0, LOG_FLUSH_INTERVAL_NSEC };
+    while (!flusher_stop) {
+        if (drain() == 0)
+            nanosleep(&interval, NULL);
+    }
+    drain();
+    return NULL;
+}
+
+// ---------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------
+
+// Empty the ring; used in fork children, which inherit the parent's
+// pending records but not its flusher thread. Slots store their sequence
+// relative to the slot index, so the zero-initialized ring is already empty.
+static void reset_ring(void) {
+    for (unsigned long i = 0; i < LOG_RING_SIZE; i++)
+        ring[i].seq = 0;
+    ring_head = 0;
+    ring_tail = 0;
+    dropped_full = 0;
+    dropped_rate = 0;
+}
+
+static void atfork_child(void) {
+    reset_ring();
+    flusher_pid = 0;
+    flusher_stop = 0;
+}
+
+void log_init(void) {
+    if (flusher_pid == getpid())
+        return;  // Already running in this process
+    if (!atexit_registered) {
+        pthread_atfork(NULL, NULL, atfork_child);
+        atexit(log_shutdown);
+        atexit_registered = 1;
+    }
+    flusher_stop = 0;
+    if (pthread_create(&flusher, NULL, flusher_main, NULL) != 0) {
+        perror("log flusher");
+        return;
+    }
+    flusher_pid = getpid();
+}
+
+void log_shutdown(void) {
+    if (flusher_pid == getpid()) {
+        flusher_stop = 1;
+        pthread_join(flusher, NULL);
+        flusher_pid = 0;
+    } else if (atexit_registered) {
+        drain();  // No flusher in this process: flush synchronously
+    }
+}
+
+void log_set_level(LogLevel level) {
+    log_level = (int)level;
+}
+
+void log_set_rate_limit(int records_per_sec) {
+    rate_limit = records_per_sec;
+}
@@ -0,0 +1,48 @@
+// log.h
+#ifndef LOG_H
+#define LOG_H
+
+// ----------------------------------------------------------
+// Asynchronous logger
+// Callers only copy the format pointer and raw arguments into a
+// lock-free per-process ring buffer; a background flusher thread does
+// the formatting and the write(). log_write is async-signal-safe, so
+// it may be called from signal handlers.
+//
+// %s arguments are copied into the record (up to 256 bytes for all of
+// one record's strings; longer ones are truncated), so stack buffers may
+// be passed. The format string itself must be a literal.
+// ----------------------------------------------------------
+
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_OFF
+} LogLevel;
+
+// Current threshold; records below it cost a single comparison
+extern volatile int log_level;
+
+// Start the flusher thread for this process (also registers atexit drain)
+void log_init(void);
+// Drain everything that is queued and stop the flusher
+void log_shutdown(void);
+
+void log_set_level(LogLevel level);
+// Maximum records per second below LOG_LEVEL_ERROR (0 = unlimited)
+void log_set_rate_limit(int records_per_sec);
+
+void log_write(LogLevel level, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+#define LOG(level, ...) \
+    do { if ((level) >= log_level) log_write((level), __VA_ARGS__); } while (0)
+
+#define LOG_DEBUG(...) LOG(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  LOG(LOG_LEVEL_INFO,  __VA_ARGS__)
+#define LOG_WARN(...)  LOG(LOG_LEVEL_WARN,  __VA_ARGS__)
+#define LOG_ERROR(...) LOG(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif  // LOG_H
@@ -23,9 +23,28 @@
 #include <sys/types.h>  // Basic system data types
 #include <sys/wait.h>   // For wait() and process handling
 #include <sys/mman.h>   // For memory mapping (shared memory)
-#include <GL/freeglut.h> // OpenGL utility toolkit for visualization
 #include "config.h" 
-#include "opengl.h"     // Custom visualization logic
+#include "state.h"      // Player and SharedState layouts
+#include "game.h"       // Engine state and tick functions
+#include "log.h"        // Asynchronous logger
+#include "pool.h"       // Fork-based worker pool for batch modes
+#include "sweep.h"      // Parameter sweeps over config fields
+#include "cache.h"      // On-disk result cache for batch modes
+#include "whatif.h"     // Forked what-if branches for live win odds
+#include "checkpoint.h" // Save and restore the full engine state
+#include "tournament.h" // Round-robin and knockout tournaments
+#include "shm.h"        // Anonymous or named SharedState segment
+#include "spectator.h"  // UNIX-socket state stream for spectators
+#include "tty.h"        // ANSI terminal front end
+#include "player_pool.h" // Pre-forked player processes
+#include "game_clock.h" // Nanosecond game clock with a warp factor
+#include "arena.h"      // One mapping for all per-match allocations
+#include "kernel.h"     // Float and fixed-point tick kernels
+#include "strategy.h"   // Pluggable effort strategies
+#include "export.h"     // Columnar per-tick export
+#include "tick_pool.h"  // Chunked ticks for giant rosters
+#include "render.h"     // Offscreen rendering to frame files
+#include "realtime.h"   // Referee pinning and tick lateness
 
 // Pointer to the shared memory structure
 SharedState *shared_state = NULL;
@@ -37,15 +56,8 @@ SharedState *shared_state = NULL;
 int my_team = -1;
 int my_player = -1;
 
-// Simulation tick configuration
-#define TICKS_PER_SECOND 10         // We divide each real second into 10 ticks
-#define TICK_SLEEP_USEC 100000      // 100 ms sleep per tick
-
-// Define custom signals to trigger different game actions
-#define SIG_WIN_ROUND  SIGUSR2      // Notify player/team of round win
-#define SIG_LOSE_ROUND SIGURG       // Notify player/team of round loss
-#define SIG_MATCH_WIN  SIGWINCH     // Match win signal
-#define SIG_MATCH_LOSE SIGIO        // Match loss signal
+// Define custom signals to trigger different game actions (the round and
+// match result signals are in game.h)
 #define SIG_JUMP       SIGUSR1      // Used to trigger jump
 #define SIG_PULL       SIGUSR2      // Used to trigger pull
 #define SIG_ALIGN      SIGRTMIN     // Custom signal for team alignment
@@ -58,11 +70,18 @@ float *team_efforts = NULL;               // Track total effort for each team
 float rope_position = 0.0f;               // Position of rope in current round
 int   game_active = 1;                    // Flag for whether game is still running
 int   round_number = 1;                   // Current round number
-time_t game_start_time;                   // When the game started
 int **energy_pipes = NULL;                // Pipes for energy communication
+int  *team_order[NUM_TEAMS];              // Player indices in ascending energy order
+int   team_order_valid[NUM_TEAMS];        // 0 until team_order has been sorted once
+static unsigned long long *team_sort_keys[NUM_TEAMS]; // Radix sort scratch (2 keys per player)
+static Arena match_arena;                 // Backs everything allocate_game() sets up
 int   window_width = 800;                 // Window size for visualization
 int   window_height = 600;
 pid_t vis_pid = -1;                       // PID for OpenGL visualizer process
+TickParams tick_params;                   // Per-tick constants derived from config
+int   headless = 0;                       // Run without players, visualizer or sleeping
+long  sim_ticks = 0;                      // Ticks simulated so far in this match
+unsigned int game_rng = 1;                // Engine RNG state (see game_rand)
 
 // Config variable to make threshold accessible by OpenGL
 float config_rope_threshold = 0.0f;  
@@ -85,7 +104,6 @@ int Energies[NUM_TEAMS * PLAYERS_PER_TEAM] = {100,100,100,100, 100,100,100,100};
 
 // Interval to print stats about teams
 #define STATS_PRINT_INTERVAL 5
-time_t last_stats_print_time = 0;
 
 // --------------------------------------------------------------------
 // Function declarations for readability
@@ -94,45 +112,332 @@ void init_visualization(int argc, char **argv);
 void visualization_loop(int argc, char **argv);
 
 void setup_signal_handlers();
-void initialize_config(const char *config_file);
-void initialize_game();
-void setup_pipes();
 void start_players();
-void referee_control();
-void request_energy_reports_partial();
-void update_rope_position_partial();
-void check_round_winner();
 void cleanup();
 void signal_handler(int sig);
 void parent_alarm_handler(int sig);
-void check_player_falls_partial();
-void recover_players_partial();
-void notify_round_result(int winning_team);
-void notify_match_result(int winning_team);
 void reset_for_new_round();
-void print_game_status();
-void print_team_stats();
 
 // Extra helper functions for visual effects and synchronization
-void align_team(int team_index);
-void align_all_teams(void);
 void alignment_handler(int sig);
-void countdown(int seconds);
 
 // --------------------------------------------------------------------
 // Main game entry point
 // --------------------------------------------------------------------
+#ifndef TUG_NO_MAIN
+// Set the log level from its name; returns -1 if the name is unknown
+static int parse_log_level(const char *name) {
+    static const char *names[] = { "debug", "info", "warn", "error", "off" };
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            log_set_level((LogLevel)i);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Show the match in shared_state with the chosen front end until it closes
+static void run_front_end(int use_tty, int fps, int argc, char **argv) {
+#ifndef TUG_NO_GL
+    if (!use_tty) {
+        init_visualization(argc, argv);
+        visualization_loop(argc, argv);
+        return;
+    }
+#endif
+    tty_viewer_run(fps);
+}
+
 int main(int argc, char *argv[]) {
-    void *map_ptr = mmap(NULL, sizeof(SharedState),
-    PROT_READ | PROT_WRITE,
-    MAP_SHARED | MAP_ANONYMOUS,
-    -1, 0);
-    if (map_ptr == MAP_FAILED) {
-    perror("mmap failed");
-    exit(EXIT_FAILURE);
+    unsigned int seed = 0;
+    int have_seed = 0;
+    const char *log_level_arg = NULL;
+    const char *config_file = NULL;
+
+    // Batch options
+    static SweepAxis sweep_axes[SWEEP_MAX_AXES];
+    const char *sweep_specs[SWEEP_MAX_AXES];
+    int num_sweep_axes = 0;
+    int batch_matches = 0;                  // 0 = the mode's default
+    int batch_jobs = pool_default_workers();
+    const char *out_path = NULL;
+    const char *tournament_arg = NULL;
+    int tournament_teams = 8;
+    const char *cache_dir = CACHE_DEFAULT_DIR;
+    double ci_width = 0.0;                  // > 0: adaptive sampling
+    int sequential = 1;
+
+    // Checkpoint options
+    const char *checkpoint_file = NULL;
+    int checkpoint_interval = CHECKPOINT_DEFAULT_INTERVAL;
+    const char *restore_file = NULL;
+
+    // Shared state options
+    const char *shm_name = NULL;
+    const char *attach_name = NULL;
+    int no_vis = 0;
+    const char *spectate_path = NULL;
+#ifdef TUG_NO_GL
+    int use_tty = 1;                        // The only front end without OpenGL
+#else
+    int use_tty = 0;
+#endif
+    int tty_fps = TTY_DEFAULT_FPS;
+    int live_matches = 1;
+    double warp = 1.0;
+    const char *export_path = NULL;
+    const char *render_dir = NULL;
+    int pin_cpu = -1;
+
+    // Command-line options (anything else is left for GLUT)
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+            have_seed = 1;
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            log_level_arg = argv[++i];
+        } else if (strcmp(argv[i], "--log-rate") == 0 && i + 1 < argc) {
+            log_set_rate_limit(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+            if (num_sweep_axes == SWEEP_MAX_AXES) {
+                fprintf(stderr, "At most %d --sweep axes\n", SWEEP_MAX_AXES);
+                exit(EXIT_FAILURE);
+            }
+            sweep_specs[num_sweep_axes++] = argv[++i];
+            headless = 1;
+        } else if (strcmp(argv[i], "--tournament") == 0 && i + 1 < argc) {
+            tournament_arg = argv[++i];
+            headless = 1;
+        } else if (strcmp(argv[i], "--teams") == 0 && i + 1 < argc) {
+            tournament_teams = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            batch_matches = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            batch_jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ci-width") == 0 && i + 1 < argc) {
+            ci_width = atof(argv[++i]);
+            if (ci_width < SWEEP_MIN_CI_WIDTH || ci_width >= 1.0) {
+                fprintf(stderr, "--ci-width must be at least %g and below 1\n",
+                        SWEEP_MIN_CI_WIDTH);
+                exit(EXIT_FAILURE);
+            }
+            headless = 1;
+        } else if (strcmp(argv[i], "--no-sprt") == 0) {
+            sequential = 0;
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            cache_dir = NULL;
+        } else if (strcmp(argv[i], "--whatif") == 0 && i + 1 < argc) {
+            whatif_enable(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpoint_file = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+            checkpoint_interval = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc) {
+            restore_file = argv[++i];
+        } else if (strcmp(argv[i], "--shm-name") == 0 && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if (strcmp(argv[i], "--attach") == 0 && i + 1 < argc) {
+            attach_name = argv[++i];
+        } else if (strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) {
+            spectate_path = argv[++i];
+        } else if (strcmp(argv[i], "--live-matches") == 0 && i + 1 < argc) {
+            live_matches = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tty") == 0) {
+            use_tty = 1;
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            tty_fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warp") == 0 && i + 1 < argc) {
+            warp = atof(argv[++i]);
+            if (warp < GAME_CLOCK_WARP_MIN || warp > GAME_CLOCK_WARP_MAX) {
+                fprintf(stderr, "--warp must be between %g and %g\n",
+                        GAME_CLOCK_WARP_MIN, GAME_CLOCK_WARP_MAX);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            tick_kernel = tick_kernel_find(argv[++i]);
+            if (!tick_kernel) {
+                fprintf(stderr, "Unknown tick kernel '%s' (float or fixed)\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--strategy") == 0 && i + 1 < argc) {
+            // TEAM=SPEC, e.g. 1=pacing or 2=./plugins/late_surge.so
+            const char *arg = argv[++i];
+            char err[256];
+            if ((arg[0] != '1' && arg[0] != '2') || arg[1] != '=') {
+                fprintf(stderr, "--strategy expects TEAM=NAME with TEAM 1 or 2\n");
+                exit(EXIT_FAILURE);
+            }
+            if (strategy_select(arg[0] - '1', arg + 2, err, sizeof(err)) != 0) {
+                fprintf(stderr, "Strategy for team %c: %s\n", arg[0], err);
+                exit(EXIT_FAILURE);
+            }
+        } else if (strcmp(argv[i], "--tick-threads") == 0 && i + 1 < argc) {
+            int n = atoi(argv[++i]);
+            if (n < 1 || n > TICK_POOL_MAX_THREADS) {
+                fprintf(stderr, "--tick-threads must be between 1 and %d\n",
+                        TICK_POOL_MAX_THREADS);
+                exit(EXIT_FAILURE);
+            }
+            tick_pool_set_threads(n);
+        } else if (strcmp(argv[i], "--numa-node") == 0 && i + 1 < argc) {
+            arena_set_numa_node(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--no-huge-pages") == 0) {
+            arena_set_huge_pages(0);
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            export_path = argv[++i];
+        } else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+            render_dir = argv[++i];
+        } else if (strcmp(argv[i], "--pin-cpu") == 0 && i + 1 < argc) {
+            pin_cpu = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-vis") == 0) {
+            no_vis = 1;
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_file = argv[++i];
+        } else if (argv[i][0] != '-' && !config_file) {
+            config_file = argv[i];  // ./tug_of_war config.txt
+        }
+    }
+
+    // Viewer only: show the match of a referee started with --shm-name
+    if (attach_name) {
+        if (shm_attach(attach_name) != 0)
+            exit(EXIT_FAILURE);
+        run_front_end(use_tty, tty_fps, argc, argv);
+        return 0;
+    }
+
+    // Load and validate the configuration (config.txt by default, if present)
+    if (!config_file && access("config.txt", R_OK) == 0)
+        config_file = "config.txt";
+    if (config_file)
+        initialize_config(config_file);
+    derive_tick_params();
+
+    // Fast-forward runs only log warnings and errors unless asked otherwise
+    // (and so do live runs drawing in this terminal)
+    log_set_level(headless || (use_tty && !no_vis) ? LOG_LEVEL_WARN : LOG_LEVEL_INFO);
+    if (log_level_arg && parse_log_level(log_level_arg) < 0) {
+        fprintf(stderr, "Unknown log level '%s'\n", log_level_arg);
+        exit(EXIT_FAILURE);
+    }
+    log_init();
+
+    // Batch modes play many matches; render one at a time instead
+    if (render_dir && (num_sweep_axes > 0 || ci_width > 0.0 || tournament_arg)) {
+        fprintf(stderr, "--render works with single matches and live matches\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Sweep: play headless matches over a grid of config values (or, for
+    // adaptive sampling alone, at the current config)
+    if (num_sweep_axes > 0 || ci_width > 0.0) {
+        char err[256];
+        for (int a = 0; a < num_sweep_axes; a++) {
+            if (sweep_parse_axis(sweep_specs[a], &sweep_axes[a], err, sizeof(err)) != 0) {
+                fprintf(stderr, "%s\n", err);
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (batch_matches < 0 || batch_jobs < 1) {
+            fprintf(stderr, "--matches and --jobs must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+        cache_set_dir(cache_dir);
+        sweep_set_export_dir(export_path);
+        sweep_set_target_width(ci_width, sequential);
+        int status = run_sweep(sweep_axes, num_sweep_axes,
+                               batch_matches > 0 ? batch_matches
+                                                 : ci_width > 0.0 ? 10000 : 100,
+                               have_seed ? seed : 1, batch_jobs,
+                               out_path ? out_path : "sweep_results.csv");
+        log_shutdown();
+        return status == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    // Tournament: teams with fixed rosters play a bracket of matches
+    if (tournament_arg) {
+        TournamentFormat format;
+        if (export_path) {
+            fprintf(stderr, "--export works with single matches and sweeps\n");
+            exit(EXIT_FAILURE);
+        }
+        if (tournament_parse_format(tournament_arg, &format) != 0) {
+            fprintf(stderr, "Unknown tournament format '%s' (roundrobin or knockout)\n",
+                    tournament_arg);
+            exit(EXIT_FAILURE);
+        }
+        if (batch_matches < 0 || batch_jobs < 1) {
+            fprintf(stderr, "--matches and --jobs must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+        int status = run_tournament(format, tournament_teams,
+                                    batch_matches > 0 ? batch_matches : 9,
+                                    have_seed ? seed : 1, batch_jobs,
+                                    out_path ? out_path : "tournament_results.csv");
+        log_shutdown();
+        return status == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    // 1. Map the state shared with the visualizer (named segments can also
+    //    be attached by independent viewers)
+    if (shm_create(shm_name) != 0) {
+        exit(EXIT_FAILURE);
+    }
+
+    // Restore replaces the config and the whole match state
+    if (restore_file) {
+        char err[256];
+        if (checkpoint_restore(restore_file, err, sizeof(err)) != 0) {
+            fprintf(stderr, "Cannot restore checkpoint: %s\n", err);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (checkpoint_file)
+        checkpoint_enable(checkpoint_file, checkpoint_interval);
+
+    // Per-tick columns for analysis, written in the background
+    if (export_path && export_open(export_path) != 0)
+        exit(EXIT_FAILURE);
+
+    // Record each tick and draw it to frame files after the match
+    if (render_dir && render_open(render_dir, window_width, window_height, batch_jobs) != 0)
+        exit(EXIT_FAILURE);
+
+    // Headless: play one match as fast as possible and report the result
+    if (headless) {
+        int winner;
+        if (restore_file) {
+            winner = finish_headless_match(NULL);
+        } else {
+            if (!have_seed)
+                seed = (unsigned int)(time(NULL) * 100003 + getpid() * 101);
+            winner = run_headless_match(seed, NULL);
+        }
+        int output_failed = render_close() != 0;
+        if (export_close() != 0)
+            output_failed = 1;
+        tick_pool_stop();
+        log_shutdown();
+        if (restore_file)
+            printf("=== HEADLESS MATCH (restored from %s) ===\n", restore_file);
+        else
+            printf("=== HEADLESS MATCH (seed %u) ===\n", seed);
+        if (winner < 0)
+            printf("Result: tie");
+        else
+            printf("Result: Team %d wins", winner + 1);
+        printf(" after %ld ticks, round wins %d-%d\n",
+               sim_ticks, team_round_wins[0], team_round_wins[1]);
+        shm_release();
+        return output_failed ? EXIT_FAILURE : 0;
     }
-shared_state = (SharedState*)map_ptr;
-memset(shared_state, 0, sizeof(SharedState));
 
     // 2. Create communication pipes between referee and players
     if (pipe(Ref_Player) == -1 || pipe(spec_pipe) == -1 ||
@@ -143,66 +448,155 @@ memset(shared_state, 0, sizeof(SharedState));
         exit(EXIT_FAILURE);
     }
 
-    // 4. Setup all teams and player attributes
-    initialize_game();
-
-    // Copy config threshold for OpenGL access
-    
-    config_rope_threshold = config.rope_threshold;
-    shared_state->round_number = round_number;
-
-    // Display basic game information
-    printf("=== TUG OF WAR GAME SIMULATION ===\n");
-    printf("Configuration:\n");
-    printf("- Teams: %d\n", config.num_teams);
-    printf("- Players per team: %d\n", config.players_per_team);
-
-    // Seed the random generator using multiple sources
-    srand(
-        (unsigned int)(
-            time(NULL) * 100003  
-            + (unsigned int)clock()
-            + getpid() * 101
-        )
-    );
-    
-    game_start_time = time(NULL);
-
-    // Reinitialize pipes for energy data
-    setup_pipes();
-
-    // Fork all players as child processes
-    start_players();
-
-    // 5. Fork another process to handle OpenGL visualization
-    vis_pid = fork();
-    if (vis_pid == 0) {
-        init_visualization(argc, argv);
-        visualization_loop(argc, argv);
-        exit(0);
-    }
-
-    // Align all teams before starting the match
-    align_all_teams();
+    // Pick up edits to the config file between ticks
+    if (config_file)
+        config_watch_start(config_file);
 
-    // Display countdown to game start
-    printf("Game starting in:\n");
-    countdown(5);
+    // Run live game time faster or slower than the wall clock
+    game_clock_set_warp(warp);
 
-    // 6. Setup a signal alarm to end the game after duration expires
+    // 6. Setup a signal alarm to end each game after its duration expires
     struct sigaction sa;
     sa.sa_handler = parent_alarm_handler;
     sigemptyset(&sa.sa_mask);
     sa.sa_flags = 0;
     sigaction(SIGALRM, &sa, NULL);
-    alarm(config.game_duration); // Trigger SIGALRM when time is up
 
-    // 7. Begin main control loop where the referee manages the game
-    referee_control();
+    // Player processes and the front end are forked once and reused by
+    // every match
+    for (int match = 1; match <= live_matches; match++) {
+        int restored = restore_file && match == 1;
+
+        // 4. Setup all teams and player attributes
+        if (match > 1) {
+            free_game();
+            reset_match_state();
+        }
+        if (!restored)
+            initialize_game();
+        export_set_match(match);
+        render_set_match(match);
+
+        // Copy config threshold for OpenGL access
+        config_rope_threshold = config.rope_threshold;
+        shared_state->round_number = round_number;
+
+        // Display basic game information
+        LOG_INFO("=== TUG OF WAR GAME SIMULATION ===\n");
+        if (live_matches > 1)
+            LOG_INFO("Match %d of %d\n", match, live_matches);
+        LOG_INFO("Configuration:\n");
+        LOG_INFO("- Teams: %d\n", config.num_teams);
+        LOG_INFO("- Players per team: %d\n", config.players_per_team);
+        if (game_clock_warp() != 1.0)
+            LOG_INFO("- Time warp: %.2fx\n", game_clock_warp());
+
+        // Seed the random generator using multiple sources
+        if (!restored) {
+            game_srand(
+                (unsigned int)(
+                    time(NULL) * 100003  
+                    + (unsigned int)clock()
+                    + getpid() * 101
+                    + match
+                )
+            );
+        }
+
+        // Hand this match's roster to the player processes
+        start_players();
+
+        // 5. Fork another process to handle OpenGL visualization (again, if
+        //    the last one closed after showing the previous result)
+        if (vis_pid > 0 && waitpid(vis_pid, NULL, WNOHANG) == vis_pid)
+            vis_pid = -1;
+        if (!no_vis && vis_pid <= 0) {
+            vis_pid = fork();
+            if (vis_pid == 0) {
+                run_front_end(use_tty, tty_fps, argc, argv);
+                exit(0);
+            }
+        }
+
+        // Stream the match to spectators (after the forks, so no child holds
+        // the listening socket or a client connection)
+        if (match == 1 && spectate_path && spectator_start(spectate_path) != 0) {
+            cleanup();  // Also stops the front end forked above
+            exit(EXIT_FAILURE);
+        }
+
+        // Pin the referee once everything it forks and starts is running,
+        // move those off its core and fault in what the ticks touch
+        if (pin_cpu >= 0) {
+            if (match == 1) {
+                if (realtime_enter(pin_cpu) != 0) {
+                    cleanup();
+                    exit(EXIT_FAILURE);
+                }
+                for (int i = 0; i < player_pool_size(); i++)
+                    realtime_move(player_pool_pid(i));
+            }
+            realtime_move(vis_pid);
+            realtime_prefault(shared_segment, sizeof(SharedSegment));
+            realtime_prefault(match_arena.base, match_arena.used);
+        }
+
+        // Align all teams before starting the match (a restored match keeps
+        // the positions it was saved with)
+        if (!restored)
+            align_all_teams();
+
+        // Display countdown to game start; game time starts when it ends
+        // (a restored match carries on from its tick)
+        LOG_INFO("Game starting in:\n");
+        countdown(5);
+
+        // 7. Begin main control loop where the referee manages the game
+        referee_control();
+        alarm(0);
+        realtime_report();
+    }
+    config_watch_stop();
+    int output_failed = export_close() != 0;
+    if (render_close() != 0)
+        output_failed = 1;
 
     // 8. Clean up memory and processes
     cleanup();
-    return 0;
+    return output_failed ? EXIT_FAILURE : 0;
+}
+
+#endif  // TUG_NO_MAIN
+
+// Map a private SharedState block (anonymous, so only forked children see it)
+int map_shared_state(void) {
+    return shm_create(NULL);
+}
+
+// Recompute the per-tick constants from the current config
+void derive_tick_params(void) {
+    tick_params.fall_probability_per_tick = config.fall_probability / (float)TICKS_PER_SECOND;
+    tick_params.decay_per_tick_scale      = 1.0f / (float)TICKS_PER_SECOND;
+    tick_params.rope_step_scale           = 0.05f / (float)TICKS_PER_SECOND;
+    tick_params.rope_threshold            = (float)config.rope_threshold;
+    tick_params.recovery_span             = config.fall_recovery_max - config.fall_recovery_min + 1;
+    tick_params.decay_divisor             = TICKS_PER_SECOND;
+    tick_params.rope_step_divisor         = 20 * TICKS_PER_SECOND;
+}
+
+// Engine random numbers. The state is a single word (rand_r), unlike the
+// hidden state behind rand(), so checkpoints can save and restore it.
+void game_srand(unsigned int seed) {
+    game_rng = seed;
+}
+
+int game_rand(void) {
+    return rand_r(&game_rng);
+}
+
+// Whole seconds of game time since the match started (see game_clock.h)
+int game_elapsed_seconds(void) {
+    return (int)(game_clock_ns() / NSEC_PER_SEC);
 }
 
 
@@ -212,14 +606,15 @@ memset(shared_state, 0, sizeof(SharedState));
 
 // Handler for the alarm signal sent when game time expires
 void parent_alarm_handler(int sig) {
-    printf("\n=== GAME TIME EXPIRED ===\n");
+    // log_write is async-signal-safe (no formatting happens here)
+    LOG_INFO("\n=== GAME TIME EXPIRED ===\n");
     game_active = 0;
 }
 
 // This handler is triggered when a signal to align teams is received
 void alignment_handler(int sig) {
     (void)sig;
-    printf("Referee signal received: Aligning teams based on effort...\n");
+    LOG_INFO("Referee signal received: Aligning teams based on effort...\n");
     align_all_teams();
 }
 
@@ -258,29 +653,93 @@ void signal_handler(int sig) {
 }
 
 
-// Main game setup logic
-void initialize_game() {
-    // Allocate 2D array of players for all teams
-    teams = malloc(config.num_teams * sizeof(Player*));
+// Bytes allocate_game() carves from the arena (must list the same blocks)
+static size_t match_state_size(void) {
+    size_t teams_n = (size_t)config.num_teams;
+    size_t players = (size_t)config.players_per_team;
+    size_t size = arena_block_size(teams_n * sizeof(Player *))
+                + teams_n * arena_block_size(players * sizeof(Player))
+                + arena_block_size(NUM_TEAMS * sizeof(float))
+                + teams_n * arena_block_size(players * sizeof(int))
+                + teams_n * arena_block_size(2 * players * sizeof(unsigned long long))
+                + arena_block_size(teams_n * players * sizeof(int *))
+                + arena_block_size(teams_n * players * 2 * sizeof(int))
+                + arena_block_size(strategy_scratch_size(config.players_per_team));
+    return size;
+}
+
+// Allocate the team, effort, ranking and pipe arrays for the current config
+// and reset the shared match flags (players are left uninitialized)
+void allocate_game(void) {
+    // One mapping holds the whole match; a later match reuses it
+    if (arena_prepare(&match_arena, match_state_size()) != 0) {
+        perror("match arena");
+        exit(EXIT_FAILURE);
+    }
+    size_t players = (size_t)config.players_per_team;
+
+    // 2D array of players for all teams, one cache-aligned row per team
+    teams = arena_alloc(&match_arena, config.num_teams * sizeof(Player *));
     for (int i = 0; i < config.num_teams; i++) {
-        teams[i] = malloc(config.players_per_team * sizeof(Player));
+        teams[i] = arena_alloc(&match_arena, players * sizeof(Player));
     }
 
-    // Get current second for use in randomization
-    time_t now = time(NULL);
-    struct tm *local_time = localtime(&now);
-    int current_second = local_time->tm_sec;
+    // Team total efforts
+    team_efforts = arena_alloc(&match_arena, NUM_TEAMS * sizeof(float));
+    memset(team_efforts, 0, NUM_TEAMS * sizeof(float));
+
+    // Ranking buffers used by align_team
+    for (int t = 0; t < config.num_teams; t++) {
+        team_order[t] = arena_alloc(&match_arena, players * sizeof(int));
+        team_sort_keys[t] = arena_alloc(&match_arena, 2 * players * sizeof(unsigned long long));
+    }
+    reset_team_order();
+
+    // Pipe ends for each player, in one block
+    size_t nplayers = (size_t)config.num_teams * players;
+    energy_pipes = arena_alloc(&match_arena, nplayers * sizeof(int *));
+    int *pipe_ends = arena_alloc(&match_arena, nplayers * 2 * sizeof(int));
+    for (size_t i = 0; i < nplayers; i++) {
+        energy_pipes[i] = pipe_ends + 2 * i;
+    }
+
+    // Per-team arrays handed to effort strategies
+    strategy_set_scratch(arena_alloc(&match_arena, strategy_scratch_size(config.players_per_team)),
+                         config.players_per_team);
+
+    // Setup shared game state memory
+    shm_write_begin();
+    shared_state->rope_position         = 0.0f;
+    shared_state->team_round_wins[0]    = 0;
+    shared_state->team_round_wins[1]    = 0;
+    shared_state->round_number          = round_number;
+    shared_state->game_ended            = 0;
+    shared_state->final_winner          = -1;
+    shm_write_end();
+}
+
+// Main game setup logic
+void initialize_game() {
+    allocate_game();
+
+    // Wall-clock second as extra randomness for live matches (headless
+    // matches must only depend on their seed)
+    int current_second = 0;
+    if (!headless) {
+        time_t now = time(NULL);
+        current_second = localtime(&now)->tm_sec;
+    }
 
     // Initialize each player's parameters
     for (int t = 0; t < config.num_teams; t++) {
         for (int p = 0; p < config.players_per_team; p++) {
             // Calculate starting energy with some randomness
-            float en = config.minimum_energy + (rand() % config.range) + (current_second % 20);
+            float en = config.minimum_energy + (game_rand() % config.range) + (current_second % 20);
             // Generate a decay rate randomly
-            float dr = 0.5f + (float)(rand() % 16) / 10.0f;
+            float dr = 0.5f + (float)(game_rand() % 16) / 10.0f;
 
             // Debug print to track initial values
-            printf("Team %d Player %d: init second=%d, raw energy=%.2f\n",
+            LOG_DEBUG("Team %d Player %d: init second=%d, raw energy=%.2f\n",
                    t, p, current_second, en);
 
             // Assign player properties
@@ -295,82 +754,120 @@ void initialize_game() {
         }
     }
 
-    // Allocate array for team total efforts
-    team_efforts = calloc(config.num_teams, sizeof(float));
+    // Copy all initialized players to the shared memory state
+    mirror_to_shared_memory();
+}
 
-    // Allocate pipe arrays for each player
-    energy_pipes = malloc(config.num_teams * config.players_per_team * sizeof(int*));
-    for (int i = 0; i < config.num_teams * config.players_per_team; i++) {
-        energy_pipes[i] = malloc(2 * sizeof(int));
+// Release everything initialize_game allocated
+void free_game(void) {
+    // Everything lives in the arena: dropping the pointers is enough
+    teams = NULL;
+    team_efforts = NULL;
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        team_order[t] = NULL;
+        team_sort_keys[t] = NULL;
     }
+    energy_pipes = NULL;
+    arena_reset(&match_arena);
+}
 
-    // Setup shared game state memory
-    shared_state->rope_position         = 0.0f;
-    shared_state->team_round_wins[0]    = 0;
-    shared_state->team_round_wins[1]    = 0;
-    shared_state->round_number          = round_number;
-    shared_state->game_ended            = 0;
-    shared_state->final_winner          = -1;
+// Reset per-match counters so another match can run in the same process
+void reset_match_state(void) {
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        team_round_wins[t] = 0;
+        team_consecutive_wins[t] = 0;
+    }
+    rope_position = 0.0f;
+    game_active   = 1;
+    round_number  = 1;
+    sim_ticks     = 0;
+    game_clock_start(0);  // Live matches restart it after the countdown
+}
 
-    // Copy all initialized players to the shared memory state
-    for (int t = 0; t < config.num_teams; t++) {
-        for (int p = 0; p < config.players_per_team; p++) {
-            shared_state->players[t][p] = teams[t][p];
+// Play one complete match without players, visualizer or sleeping.
+// The same seed always produces the same match. Returns the winning
+// team index, or -1 for a tie, and fills *result when it is not NULL.
+// shared_state must already be mapped.
+int run_headless_match(unsigned int seed, MatchResult *result) {
+    return run_headless_match_rosters(seed, NULL, result);
+}
+
+// As run_headless_match, but when rosters is not NULL each team plays with
+// the energy and decay rate of rosters[t][p] instead of generated players
+// (tournament teams keep the same players from match to match).
+int run_headless_match_rosters(unsigned int seed, const Player *const rosters[NUM_TEAMS],
+                               MatchResult *result) {
+    headless = 1;
+    reset_match_state();
+    derive_tick_params();
+    game_srand(seed);
+    export_set_match(seed);
+    render_set_match(seed);
+
+    initialize_game();
+    if (rosters) {
+        for (int t = 0; t < config.num_teams; t++) {
+            for (int p = 0; p < config.players_per_team; p++) {
+                teams[t][p].energy     = rosters[t][p].energy;
+                teams[t][p].effort     = rosters[t][p].energy;
+                teams[t][p].decay_rate = rosters[t][p].decay_rate;
+            }
         }
+        mirror_to_shared_memory();
     }
+    config_rope_threshold = config.rope_threshold;
+    align_all_teams();
+
+    return finish_headless_match(result);
 }
 
-// Create a pipe for each player to communicate with the parent
-void setup_pipes() {
-    for (int i = 0; i < config.num_teams * config.players_per_team; i++) {
-        if (pipe(energy_pipes[i]) != 0) {
-            perror("pipe failed");
-            exit(EXIT_FAILURE);
-        }
+// Play the current (new or restored) match to the end without players,
+// visualizer or sleeping, then release it. Returns the winning team
+// index, or -1 for a tie, and fills *result when it is not NULL.
+int finish_headless_match(MatchResult *result) {
+    headless = 1;
+    referee_control();
+
+    int winner = shared_state->game_ended ? shared_state->final_winner : -1;
+    if (result) {
+        result->winner = winner;
+        result->rounds_played = round_number;
+        for (int t = 0; t < NUM_TEAMS; t++)
+            result->round_wins[t] = team_round_wins[t];
+        result->ticks = sim_ticks;
+        result->final_rope_position = rope_position;
     }
+    free_game();
+    return winner;
 }
 
-// Start player processes using fork
+// Hand the current roster to the player processes. They are forked once,
+// on first use, and reset in place for every later match.
 void start_players() {
+    int nplayers = config.num_teams * config.players_per_team;
+    if (player_pool_size() != nplayers) {
+        player_pool_stop();
+        if (player_pool_start(nplayers) != 0)
+            exit(EXIT_FAILURE);
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (player_pool_reset((unsigned int)(time(NULL) * 100003 + (unsigned int)clock())) != 0)
+        LOG_WARN("Not every player process acknowledged the reset\n");
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    LOG_DEBUG("Players ready in %.3f ms\n",
+              (double)(t1.tv_sec - t0.tv_sec) * 1e3 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-6);
+
     int player_idx = 0;
     for (int t = 0; t < config.num_teams; t++) {
         for (int p = 0; p < config.players_per_team; p++) {
-            pid_t pid = fork();
-            if (pid == 0) {
-                // In child process: seed random with unique values
-                srand((unsigned int)(time(NULL) * 100003 + (unsigned int)clock() + getpid() * 101));
-
-                // Save this player's identifiers
-                my_team = t;
-                my_player = p;
-
-                // Close read-end of pipe (child only writes)
-                close(energy_pipes[player_idx][0]);
-
-                // Setup signals
-                setup_signal_handlers();
-
-                // Set alarm to trigger periodically
-                alarm(1 + rand() % 3);
-
-                // Wait for signals to activate
-                while (1) {
-                    pause();
-
-                    // Exit if effort drops to zero
-                    if (teams[my_team][my_player].effort <= 0) {
-                        exit(EXIT_SUCCESS);
-                    }
-                }
-            } else {
-                // In parent: store child's PID
-                teams[t][p].pid = pid;
-                shared_state->players[t][p].pid = pid;
-
-                // Close write-end of pipe (parent only reads)
-                close(energy_pipes[player_idx][1]);
-                player_idx++;
-            }
+            teams[t][p].pid = player_pool_pid(player_idx);
+            if (t < NUM_TEAMS && p < PLAYERS_PER_TEAM)  // The shared block's rows
+                shared_state->players[t][p].pid = teams[t][p].pid;
+            energy_pipes[player_idx][0] = player_pool_energy_fd(player_idx);
+            energy_pipes[player_idx][1] = -1;  // Held by the player only
+            player_idx++;
         }
     }
 }
@@ -381,24 +878,49 @@ void start_players() {
 
 // This is the core loop run by the referee to manage game progress
 void referee_control() {
-    int ticks_this_second = 0;
-    time_t round_start = time(NULL);
-    last_stats_print_time = time(NULL);
-    static int in_game_seconds_passed = 0;
+    // Derived from sim_ticks so a restored checkpoint resumes mid-second
+    int ticks_this_second = (int)(sim_ticks % TICKS_PER_SECOND);
+    int in_game_seconds_passed = (int)(sim_ticks / TICKS_PER_SECOND);
 
     while (game_active) {
-        // Run substeps of the simulation logic
-        check_player_falls_partial();
-        recover_players_partial();
-        request_energy_reports_partial();
-        update_rope_position_partial();
+        // Apply a reloaded config only here, between two whole ticks
+        if (!headless && config_poll_reload()) {
+            derive_tick_params();
+            config_rope_threshold = config.rope_threshold;
+        }
+
+        // Run substeps of the simulation logic (in chunks on the tick
+        // pool, if selected)
+        if (tick_chunked) {
+            tick_pool_tick();
+        } else {
+            check_player_falls_partial();
+            recover_players_partial();
+            request_energy_reports_partial();
+            update_rope_position_partial();
+        }
 
         // Synchronize shared memory state
         mirror_to_shared_memory();
 
-        // Sleep for one game tick
-        usleep(TICK_SLEEP_USEC);
+        // Refresh the win-probability estimate from forked branches
+        if (!headless)
+            whatif_tick();
+
+        // Wait for the next tick on the game clock (headless runs just
+        // advance the clock; a tick that ran late does not sleep)
+        int64_t deadline = (int64_t)(sim_ticks + 1) * TICK_NSEC;
+        int overran = !headless && game_clock_ns() >= deadline;
+        game_clock_sleep_until(deadline);
+        if (!headless)
+            realtime_tick_late(overran, (int64_t)((double)(game_clock_ns() - deadline) /
+                                                  game_clock_warp()));
+        sim_ticks++;
         ticks_this_second++;
+        if (export_active)
+            export_tick();
+        if (render_active)
+            render_capture();
 
         // Every second, perform time-based updates
         if (ticks_this_second >= TICKS_PER_SECOND) {
@@ -406,14 +928,13 @@ void referee_control() {
             in_game_seconds_passed++;
 
             // Print game stats every 5 seconds
-            if (in_game_seconds_passed % 5 == 0) {
+            if (!headless && in_game_seconds_passed % 5 == 0) {
                 print_team_stats();
             }
 
-            time_t now = time(NULL);
             // End game if duration expired
-            if ((now - game_start_time) >= config.game_duration) {
-                printf("\n=== GAME TIME EXPIRED ===\n");
+            if (game_elapsed_seconds() >= config.game_duration) {
+                LOG_INFO("\n=== GAME TIME EXPIRED ===\n");
                 game_active = 0;
                 print_game_status();
                 break;
@@ -422,41 +943,58 @@ void referee_control() {
             // Check if a team won the round
             check_round_winner();
         }
+
+        // Save a checkpoint between two whole ticks
+        if (game_active)
+            checkpoint_tick();
     }
 
     // Determine final match result if game ended
-    time_t now = time(NULL);
-    if ((now - game_start_time) >= config.game_duration) {
+    if (game_elapsed_seconds() >= config.game_duration) {
         if (team_round_wins[0] > team_round_wins[1]) {
-            printf("\n=== GAME TIME EXPIRED: Team 1 wins the match by round wins! ===\n");
+            LOG_INFO("\n=== GAME TIME EXPIRED: Team 1 wins the match by round wins! ===\n");
             notify_match_result(0);
         } else if (team_round_wins[1] > team_round_wins[0]) {
-            printf("\n=== GAME TIME EXPIRED: Team 2 wins the match by round wins! ===\n");
+            LOG_INFO("\n=== GAME TIME EXPIRED: Team 2 wins the match by round wins! ===\n");
             notify_match_result(1);
         } else {
-            printf("\n=== GAME TIME EXPIRED: The match is a tie! ===\n");
+            LOG_INFO("\n=== GAME TIME EXPIRED: The match is a tie! ===\n");
         }
     }
+
+    // The final state, for the result screen
+    if (render_active)
+        render_capture();
 }
 
 // Sync the current internal game state with the shared memory block
 void mirror_to_shared_memory() {
+    // The shared block only has room for NUM_TEAMS x PLAYERS_PER_TEAM
+    int num_teams = config.num_teams < NUM_TEAMS ? config.num_teams : NUM_TEAMS;
+    int num_players = config.players_per_team < PLAYERS_PER_TEAM
+                    ? config.players_per_team : PLAYERS_PER_TEAM;
+
+    shm_write_begin();
     shared_state->rope_position = rope_position;
     shared_state->round_number  = round_number;
+    shared_state->rope_threshold  = (float)config.rope_threshold;
+    shared_state->elapsed_seconds = game_elapsed_seconds();
+    shared_state->time_warp       = headless ? 0.0f : (float)game_clock_warp();
     shared_state->team_round_wins[0] = team_round_wins[0];
     shared_state->team_round_wins[1] = team_round_wins[1];
 
     // Copy team effort values
-    for (int t = 0; t < config.num_teams; t++) {
+    for (int t = 0; t < num_teams; t++) {
         shared_state->team_efforts[t] = team_efforts[t];
     }
 
     // Copy each player's current status
-    for (int t = 0; t < config.num_teams; t++) {
-        for (int p = 0; p < config.players_per_team; p++) {
+    for (int t = 0; t < num_teams; t++) {
+        for (int p = 0; p < num_players; p++) {
             shared_state->players[t][p] = teams[t][p];
         }
     }
+    shm_write_end();
 }
 
 // --------------------------------------------------------------------
@@ -465,41 +1003,40 @@ void mirror_to_shared_memory() {
 
 // Print current stats for teams and players
 void print_team_stats() {
-    time_t now = time(NULL);
-    int elapsed = (int)(now - game_start_time);
-    printf("\n=== Game Stats at %d seconds (Round %d) ===\n", elapsed, round_number);
-    printf("Rope Position: %.2f/%.2f\n", rope_position, config.rope_threshold);
-    printf("Scores: Team 1: %d, Team 2: %d\n", team_round_wins[0], team_round_wins[1]);
-    for (int t = 0; t < NUM_TEAMS; t++) {
-        printf("\nTeam %d Players:\n", t + 1);
-        printf("ID  | Energy | Effort | Status     | Position\n");
-        printf("----|--------|--------|------------|---------\n");
-        for (int p = 0; p < PLAYERS_PER_TEAM; p++) {
-            printf("%2d  | %6.1f | %6.1f | %-10s | %d\n",
+    int elapsed = game_elapsed_seconds();
+    LOG_INFO("\n=== Game Stats at %d seconds (Round %d) ===\n", elapsed, round_number);
+    LOG_INFO("Rope Position: %.2f/%.2f\n", rope_position, config.rope_threshold);
+    LOG_INFO("Scores: Team 1: %d, Team 2: %d\n", team_round_wins[0], team_round_wins[1]);
+    for (int t = 0; t < config.num_teams; t++) {
+        LOG_INFO("\nTeam %d Players:\n", t + 1);
+        LOG_INFO("ID  | Energy | Effort | Status     | Position\n");
+        LOG_INFO("----|--------|--------|------------|---------\n");
+        for (int p = 0; p < config.players_per_team; p++) {
+            LOG_INFO("%2d  | %6.1f | %6.1f | %-10s | %d\n",
                    p + 1,
                    teams[t][p].energy,
                    teams[t][p].effort,
                    teams[t][p].recovering ? "Recovering" : (teams[t][p].active ? "Active" : "Inactive"),
                    teams[t][p].position);
         }
-        printf("Total Team Effort: %.2f\n", team_efforts[t]);
+        LOG_INFO("Total Team Effort: %.2f\n", team_efforts[t]);
     }
-    printf("\n");
+    LOG_INFO("\n");
 }
 
 // Check if any player falls down due to fatigue or randomness
 void check_player_falls_partial() {
-    float p_fall_this_tick = config.fall_probability / (float)TICKS_PER_SECOND;
+    float p_fall_this_tick = tick_params.fall_probability_per_tick;
     for (int t = 0; t < config.num_teams; t++) {
         for (int p = 0; p < config.players_per_team; p++) {
             if (teams[t][p].active && !teams[t][p].recovering) {
-                float r = (float)rand() / (float)RAND_MAX;
+                float r = (float)game_rand() / (float)RAND_MAX;
                 if (r < p_fall_this_tick) {
                     teams[t][p].recovering = 1;
                     teams[t][p].effort = 0.0f;
-                    teams[t][p].recover_time = time(NULL) +
-                        (rand() % (config.fall_recovery_max - config.fall_recovery_min + 1))
-                        + config.fall_recovery_min;
+                    teams[t][p].recover_time = game_clock_ns() +
+                        ((game_rand() % tick_params.recovery_span)
+                         + config.fall_recovery_min) * NSEC_PER_SEC;
                 }
             }
         }
@@ -508,7 +1045,7 @@ void check_player_falls_partial() {
 
 // This function checks if recovering players have finished their recovery period
 void recover_players_partial() {
-    time_t now = time(NULL);  // Get current time
+    int64_t now = game_clock_ns();  // Current game time
     for (int t = 0; t < config.num_teams; t++) {
         for (int p = 0; p < config.players_per_team; p++) {
             // If a player is recovering and their recovery time has passed
@@ -520,55 +1057,17 @@ void recover_players_partial() {
     }
 }
 
-// This function updates the effort of active, non-recovering players
+// Decay energy and update effort (see kernel.h and strategy.h)
 void request_energy_reports_partial() {
-    for (int t = 0; t < config.num_teams; t++) {
-        for (int p = 0; p < config.players_per_team; p++) {
-            if (teams[t][p].active && !teams[t][p].recovering) {
-                // First, apply energy decay per tick
-                float dec = teams[t][p].decay_rate / (float)TICKS_PER_SECOND;
-                teams[t][p].energy -= dec;
-
-                // Make sure energy doesn’t go negative
-                if (teams[t][p].energy < 0)
-                    teams[t][p].energy = 0;
-
-                // Set effort as energy multiplied by the player's position (1..4)
-                int pos = teams[t][p].position;
-                teams[t][p].effort = teams[t][p].energy * (float)pos;
-            }
-        }
-    }
+    if (strategy_active())
+        strategy_energy_reports();
+    else
+        tick_kernel_current()->energy_reports();
 }
 
-// Calculates total effort for both teams and updates rope position accordingly
+// Sum team efforts and move the rope
 void update_rope_position_partial() {
-    float total_effort[NUM_TEAMS] = {0.0f, 0.0f};
-
-    // Sum up effort from all active and non-recovering players
-    for (int t = 0; t < config.num_teams; t++) {
-        for (int p = 0; p < config.players_per_team; p++) {
-            if (teams[t][p].active && !teams[t][p].recovering) {
-                total_effort[t] += teams[t][p].effort;
-            }
-        }
-    }
-
-    // Store calculated team efforts in the global array
-    for (int t = 0; t < config.num_teams; t++) {
-        team_efforts[t] = total_effort[t];
-    }
-
-    // Determine how much the rope moves this tick based on effort difference
-    float diff = total_effort[0] - total_effort[1];
-    float increment = (diff * 0.05f) / (float)TICKS_PER_SECOND;
-    rope_position -= increment;
-
-    // Clamp rope position within allowed threshold
-    if (rope_position > config.rope_threshold)
-        rope_position = config.rope_threshold;
-    if (rope_position < -config.rope_threshold)
-        rope_position = -config.rope_threshold;
+    tick_kernel_current()->rope_update();
 }
 
 // Checks if a round has ended, determines the winner, and prepares for the next round
@@ -600,7 +1099,7 @@ void check_round_winner() {
 
         // If all players are exhausted, announce the round winner based on rope state
         if (allExhausted) {
-            printf("=== All players exhausted. Round winner: Team %d ===\n", winning_team + 1);
+            LOG_INFO("=== All players exhausted. Round winner: Team %d ===\n", winning_team + 1);
             team_round_wins[winning_team]++;
             notify_round_result(winning_team);
             game_active = 0;
@@ -621,7 +1120,7 @@ void check_round_winner() {
 
             // Check if team has won enough rounds in a row to win the match
             if (team_consecutive_wins[winning_team] >= config.consecutive_rounds_to_win) {
-                printf("=== Team %d wins the match by achieving %d consecutive wins! ===\n",
+                LOG_INFO("=== Team %d wins the match by achieving %d consecutive wins! ===\n",
                        winning_team + 1, config.consecutive_rounds_to_win);
                 game_active = 0;
                 notify_match_result(winning_team);
@@ -629,11 +1128,11 @@ void check_round_winner() {
             }
 
             // Prepare for a new round: align teams and reset rope
-            printf("Aligning teams for new round...\n");
+            LOG_INFO("Aligning teams for new round...\n");
             align_all_teams();
 
             // Countdown before restarting the round
-            printf("Next round starting in:\n");
+            LOG_INFO("Next round starting in:\n");
             countdown(5);
 
             round_number++;
@@ -647,9 +1146,11 @@ void check_round_winner() {
 
 // Notifies all players about the round result using signals
 void notify_round_result(int winning_team) {
-    printf("=== Round Winner: Team %d ===\n", winning_team+1);
+    LOG_INFO("=== Round Winner: Team %d ===\n", winning_team+1);
     for (int t = 0; t < config.num_teams; t++) {
         for (int p = 0; p < config.players_per_team; p++) {
+            if (teams[t][p].pid <= 0)
+                continue;  // No process behind this player (headless)
             if (t == winning_team)
                 kill(teams[t][p].pid, SIG_WIN_ROUND);  // Signal win
             else
@@ -660,12 +1161,14 @@ void notify_round_result(int winning_team) {
 
 // Notifies players about the final match result
 void notify_match_result(int winning_team) {
-    printf("=== Match Winner: Team %d ===\n", winning_team+1);
+    LOG_INFO("=== Match Winner: Team %d ===\n", winning_team+1);
+    shm_write_begin();
     shared_state->final_winner = winning_team;
     shared_state->game_ended = 1;
+    shm_write_end();
     for (int t = 0; t < config.num_teams; t++) {
         for (int p = 0; p < config.players_per_team; p++) {
-            if (kill(teams[t][p].pid, 0) == 0) {
+            if (teams[t][p].pid > 0 && kill(teams[t][p].pid, 0) == 0) {
                 if (t == winning_team)
                     kill(teams[t][p].pid, SIG_MATCH_WIN);
                 else
@@ -675,64 +1178,127 @@ void notify_match_result(int winning_team) {
     }
 }
 
-// Aligns players on a single team by sorting them by energy
-void align_team(int team_index) {
-    int indices[config.players_per_team];
+// Rosters up to this size are sorted from scratch by insertion sort
+#define ALIGN_INSERTION_MAX 64
 
-    // Collect player indices for sorting
-    for (int i = 0; i < config.players_per_team; i++) {
-        indices[i] = i;
+static int energy_before(const Player *team, int a, int b) {
+    return team[a].energy < team[b].energy ||
+           (team[a].energy == team[b].energy && a < b);
+}
+
+// Sort a team from scratch. Energies are never negative, so their IEEE bit
+// patterns order like unsigned integers; (energy bits << 32 | index) keys
+// are radix-sorted one byte at a time, skipping bytes that are equal in
+// every key. Ties end up ordered by player index.
+static void radix_rank_team(int team_index) {
+    Player *team = teams[team_index];
+    int n = config.players_per_team;
+    unsigned long long *keys = team_sort_keys[team_index];
+    unsigned long long *tmp = keys + n;
+
+    unsigned long long all_or = 0, all_and = ~0ULL;
+    for (int i = 0; i < n; i++) {
+        unsigned int bits;
+        memcpy(&bits, &team[i].energy, sizeof(bits));
+        keys[i] = ((unsigned long long)bits << 32) | (unsigned int)i;
+        all_or |= keys[i];
+        all_and &= keys[i];
     }
 
-    // Simple bubble sort to sort indices based on player energy
-    for (int i = 0; i < config.players_per_team - 1; i++) {
-        for (int j = i + 1; j < config.players_per_team; j++) {
-            if (teams[team_index][indices[i]].energy > teams[team_index][indices[j]].energy) {
-                int temp = indices[i];
-                indices[i] = indices[j];
-                indices[j] = temp;
-            }
-        }
+    for (int shift = 0; shift < 64; shift += 8) {
+        if ((((all_or ^ all_and) >> shift) & 0xFF) == 0)
+            continue;  // Same byte everywhere: this pass would not move anything
+        int count[257] = {0};
+        for (int i = 0; i < n; i++)
+            count[((keys[i] >> shift) & 0xFF) + 1]++;
+        for (int b = 0; b < 256; b++)
+            count[b + 1] += count[b];
+        for (int i = 0; i < n; i++)
+            tmp[count[(keys[i] >> shift) & 0xFF]++] = keys[i];
+        unsigned long long *swap = keys;
+        keys = tmp;
+        tmp = swap;
     }
 
-    int new_order[config.players_per_team];
+    int *order = team_order[team_index];
+    for (int i = 0; i < n; i++)
+        order[i] = (int)(keys[i] & 0xFFFFFFFFULL);
+}
 
-    // For Team 1, higher energy players get higher positions
-    // For Team 2, lower energy players get lower positions
-    if (team_index == 0) {
-        new_order[0] = indices[3];
-        new_order[1] = indices[2];
-        new_order[2] = indices[1];
-        new_order[3] = indices[0];
-    } else {
-        new_order[0] = indices[0];
-        new_order[1] = indices[1];
-        new_order[2] = indices[2];
-        new_order[3] = indices[3];
+// Bring team_order[team_index] back into ascending energy order.
+// The first call sorts from scratch (radix sort, O(n)). Later calls start
+// from the previous order and only move the players whose energy rank
+// changed (insertion sort, O(n + moves)); if too much has changed they
+// fall back to a full sort.
+static void rank_team(int team_index) {
+    Player *team = teams[team_index];
+    int *order = team_order[team_index];
+    int n = config.players_per_team;
+
+    long budget = 2L * n;  // Moves allowed before a full sort is cheaper
+    if (!team_order_valid[team_index] && n <= ALIGN_INSERTION_MAX) {
+        // Small rosters: an insertion sort from scratch beats the radix passes
+        for (int i = 0; i < n; i++)
+            order[i] = i;
+        team_order_valid[team_index] = 1;
+        budget = (long)n * n;
     }
 
-    // Assign positions and recalculate effort accordingly
-    for (int i = 0; i < config.players_per_team; i++) {
-        if (team_index == 0) {
-            teams[team_index][ new_order[i] ].position = 4 - i;
-        } else {
-            teams[team_index][ new_order[i] ].position = i + 1;
+    if (team_order_valid[team_index]) {
+        for (int i = 1; i < n && budget >= 0; i++) {
+            int idx = order[i];
+            int j = i - 1;
+            while (j >= 0 && energy_before(team, idx, order[j])) {
+                order[j + 1] = order[j];
+                j--;
+                budget--;
+            }
+            order[j + 1] = idx;
         }
+        if (budget >= 0)
+            return;
+    }
 
-        teams[team_index][ new_order[i] ].effort =
-            teams[team_index][ new_order[i] ].energy * (float)teams[team_index][ new_order[i] ].position;
+    radix_rank_team(team_index);
+    team_order_valid[team_index] = 1;
+}
+
+// Forget the previous ranking (next alignment sorts from scratch)
+void reset_team_order(void) {
+    for (int t = 0; t < NUM_TEAMS; t++)
+        team_order_valid[t] = 0;
+}
+
+// Aligns players on a single team by sorting them by energy.
+// Both teams put their strongest player at the highest position, so the
+// rank in ascending energy order gives position = rank + 1.
+void align_team(int team_index) {
+    int n = config.players_per_team;
+    Player *team = teams[team_index];
+    int *order = team_order[team_index];
+
+    rank_team(team_index);
+
+    // Assign positions and recalculate effort accordingly
+    for (int rank = 0; rank < n; rank++) {
+        Player *pl = &team[order[rank]];
+        pl->position = rank + 1;
+        pl->effort = pl->energy * (float)pl->position;
     }
 
     // Print new team order for debugging
-    printf("Team %d aligned order (player index: new position, energy, effort): ", team_index + 1);
-    for (int i = 0; i < config.players_per_team; i++) {
-        int idx = new_order[i];
-        printf("(%d: %d, %.1f, %.1f) ", idx,
-               teams[team_index][idx].position,
-               teams[team_index][idx].energy,
-               teams[team_index][idx].effort);
+    // (Team 1 is listed strongest first, Team 2 weakest first)
+    if (log_level > LOG_LEVEL_DEBUG)
+        return;
+    LOG_DEBUG("Team %d aligned order (player index: new position, energy, effort): ", team_index + 1);
+    for (int i = 0; i < n; i++) {
+        int idx = team_index == 0 ? order[n - 1 - i] : order[i];
+        LOG_DEBUG("(%d: %d, %.1f, %.1f) ", idx,
+               team[idx].position,
+               team[idx].energy,
+               team[idx].effort);
     }
-    printf("\n");
+    LOG_DEBUG("\n");
 }
 
 // Aligns both teams before a new round begins
@@ -747,37 +1313,47 @@ void align_all_teams(void) {
 
 // Simple countdown before the game resumes
 void countdown(int seconds) {
+    if (headless)
+        return;  // Nobody is watching a headless match
     for (int i = seconds; i > 0; i--) {
-        printf("%d...\n", i);
-        fflush(stdout);
-        sleep(1);
+        LOG_INFO("%d...\n", i);
+        game_clock_sleep(NSEC_PER_SEC);
     }
-    printf("Go!\n");
+    LOG_INFO("Go!\n");
+
+    // The countdown is not match time: the game clock resumes at the
+    // current tick, so the next tick is not already overdue
+    game_clock_start((int64_t)sim_ticks * TICK_NSEC);
+
+    // SIGALRM is a backstop one real second after the game clock runs out
+    int64_t remaining_ns = (int64_t)config.game_duration * NSEC_PER_SEC - game_clock_ns();
+    double remaining = (double)remaining_ns / NSEC_PER_SEC / game_clock_warp();
+    alarm(remaining > 0 ? (unsigned int)ceil(remaining) + 1 : 1);
 }
 
 // Cleans up allocated memory and shared state before exit
 void cleanup() {
+    whatif_stop();
+    spectator_stop();
+    tick_pool_stop();
+    player_pool_stop();  // Tell the players to exit and reap them
     if (vis_pid > 0) {
         kill(vis_pid, SIGTERM);  // Kill visualization process
         waitpid(vis_pid, NULL, 0);  // Wait for it to finish
     }
-    for (int t = 0; t < config.num_teams; t++) {
-        free(teams[t]);  // Free each team's memory
-    }
-    free(teams);  // Free top-level pointer
-    free(team_efforts);  // Free efforts array
+    free_game();  // Free teams, efforts and pipe arrays
+    arena_release(&match_arena);
+    log_shutdown();  // Flush anything still queued
 
-    if (shared_state) {
-        munmap(shared_state, sizeof(SharedState));  // Unmap shared memory
-    }
+    shm_release();  // Unmap (and unlink a named) shared memory
 }
 
 // Displays game status such as rope position and team stats
 void print_game_status() {
-    printf("\n=== GAME STATUS ===\n");
-    printf("Rope Position: %.2f\n", rope_position);
+    LOG_INFO("\n=== GAME STATUS ===\n");
+    LOG_INFO("Rope Position: %.2f\n", rope_position);
     for (int t = 0; t < config.num_teams; t++) {
-        printf("Team %d: Round Wins: %d, Consecutive Wins: %d, Total Effort: %.2f\n",
+        LOG_INFO("Team %d: Round Wins: %d, Consecutive Wins: %d, Total Effort: %.2f\n",
                t + 1, team_round_wins[t], team_consecutive_wins[t], team_efforts[t]);
     }
 }
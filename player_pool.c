@@ -0,0 +1,241 @@
+// Pre-forked player process pool (see player_pool.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "player_pool.h"
+#include "game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+
+// How long the referee waits for all players to acknowledge a command
+#define POOL_ACK_TIMEOUT_SEC 5
+
+enum {
+    POOL_CMD_NONE,
+    POOL_CMD_RESET,
+    POOL_CMD_EXIT
+};
+
+// Lives in a MAP_SHARED mapping seen by the referee and every player
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;       // Referee -> players: new command
+    pthread_cond_t  done;       // Players -> referee: acknowledgements
+    unsigned int    epoch;      // Bumped with every command
+    int             command;
+    unsigned int    seed;
+    int             acked;      // Players that have handled this epoch
+} CommandBlock;
+
+static CommandBlock *block = NULL;
+static pid_t *pids = NULL;
+static int *energy_fds = NULL;
+static int pool_size = 0;
+
+static int probe_enabled = 0;
+static PlayerProbe *probes = NULL;      // One per slot, shared with the players
+static size_t probes_size = 0;
+static int probe_slot = -1;             // This player's slot (player side)
+
+// ---------------------------------------------------------------------
+// Player side
+// ---------------------------------------------------------------------
+static void probe_handler(int sig) {
+    (void)sig;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);  // Async-signal-safe
+    PlayerProbe *probe = &probes[probe_slot];
+    probe->last_ns = (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    __atomic_store_n(&probe->count, probe->count + 1, __ATOMIC_RELEASE);
+}
+
+static void player_main(int slot) {
+    // Never outlive the referee, even if it is killed
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    setup_signal_handlers();
+    if (probes) {
+        probe_slot = slot;
+        struct sigaction sa;
+        sa.sa_handler = probe_handler;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction(SIG_WIN_ROUND, &sa, NULL);
+        sigaction(SIG_LOSE_ROUND, &sa, NULL);
+    }
+
+    unsigned int seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&block->lock);
+        while (block->epoch == seen)
+            pthread_cond_wait(&block->wake, &block->lock);
+        seen = block->epoch;
+        int command = block->command;
+        unsigned int seed = block->seed;
+        block->acked++;
+        pthread_cond_broadcast(&block->done);
+        pthread_mutex_unlock(&block->lock);
+
+        if (command == POOL_CMD_EXIT)
+            _exit(EXIT_SUCCESS);
+
+        // New match: fresh random stream and the periodic alarm
+        srand(seed + (unsigned int)slot * 101u);
+        alarm(1 + rand() % 3);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Referee side
+// ---------------------------------------------------------------------
+
+// Publish a command and wait until every player has taken it
+static int send_command(int command, unsigned int seed, int wait_acks) {
+    pthread_mutex_lock(&block->lock);
+    block->command = command;
+    block->seed = seed;
+    block->acked = 0;
+    block->epoch++;
+    pthread_cond_broadcast(&block->wake);
+
+    int status = 0;
+    if (wait_acks) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += POOL_ACK_TIMEOUT_SEC;
+        while (block->acked < pool_size && status == 0) {
+            if (pthread_cond_timedwait(&block->done, &block->lock, &deadline) == ETIMEDOUT)
+                status = -1;
+        }
+    }
+    pthread_mutex_unlock(&block->lock);
+    return status;
+}
+
+int player_pool_start(int nplayers) {
+    block = mmap(NULL, sizeof(CommandBlock), PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED) {
+        perror("player pool mmap");
+        block = NULL;
+        return -1;
+    }
+    memset(block, 0, sizeof(*block));
+    pthread_mutexattr_t mattr;
+    pthread_mutexattr_init(&mattr);
+    pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&block->lock, &mattr);
+    pthread_mutexattr_destroy(&mattr);
+    pthread_condattr_t cattr;
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&block->wake, &cattr);
+    pthread_cond_init(&block->done, &cattr);
+    pthread_condattr_destroy(&cattr);
+
+    pids = calloc((size_t)nplayers, sizeof(pid_t));
+    energy_fds = malloc((size_t)nplayers * sizeof(int));
+    if (!pids || !energy_fds) {
+        perror("player pool");
+        return -1;
+    }
+    if (probe_enabled) {
+        probes_size = (size_t)nplayers * sizeof(PlayerProbe);
+        probes = mmap(NULL, probes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (probes == MAP_FAILED) {
+            perror("player probe mmap");
+            probes = NULL;
+            return -1;
+        }
+    }
+
+    fflush(NULL);  // Players exit with _exit, but keep the streams clean
+    for (int i = 0; i < nplayers; i++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            int saved = errno;
+            perror("pipe failed");
+            player_pool_stop();
+            errno = saved;
+            return -1;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            for (int j = 0; j < i; j++)
+                close(energy_fds[j]);  // Other players' read ends
+            player_main(i);
+        }
+        close(fds[1]);  // Parent only reads
+        if (pid < 0) {
+            int saved = errno;
+            perror("fork failed");
+            close(fds[0]);
+            player_pool_stop();
+            errno = saved;
+            return -1;
+        }
+        pids[i] = pid;
+        energy_fds[i] = fds[0];
+        pool_size = i + 1;
+    }
+    return 0;
+}
+
+int player_pool_size(void) {
+    return pool_size;
+}
+
+int player_pool_reset(unsigned int seed) {
+    return pool_size > 0 ? send_command(POOL_CMD_RESET, seed, 1) : -1;
+}
+
+pid_t player_pool_pid(int slot) {
+    return pids[slot];
+}
+
+int player_pool_energy_fd(int slot) {
+    return energy_fds[slot];
+}
+
+void player_pool_stop(void) {
+    if (!block)
+        return;
+    if (pool_size > 0)
+        send_command(POOL_CMD_EXIT, 0, 0);
+    for (int i = 0; i < pool_size; i++) {
+        pid_t r;
+        do {
+            r = waitpid(pids[i], NULL, 0);
+        } while (r < 0 && errno == EINTR);
+        close(energy_fds[i]);
+    }
+    free(pids);
+    free(energy_fds);
+    pids = NULL;
+    energy_fds = NULL;
+    pool_size = 0;
+    munmap(block, sizeof(CommandBlock));
+    block = NULL;
+    if (probes) {
+        munmap(probes, probes_size);
+        probes = NULL;
+    }
+}
+
+void player_pool_enable_probe(int enable) {
+    probe_enabled = enable;
+}
+
+const volatile PlayerProbe *player_pool_probe(int slot) {
+    return probes ? &probes[slot] : NULL;
+}
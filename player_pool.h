@@ -0,0 +1,47 @@
+// player_pool.h
+#ifndef PLAYER_POOL_H
+#define PLAYER_POOL_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// ----------------------------------------------------------
+// Pre-forked player processes. The pool forks one process per roster
+// slot once; before every match the referee resets all of them in place
+// through a command block in shared memory (a process-shared mutex and
+// condition variables), so starting a match costs one broadcast instead
+// of a fork per player. Each process keeps an energy pipe for the whole
+// run. player_pool_stop() tells them to exit and reaps every one.
+// ----------------------------------------------------------
+
+// Fork nplayers processes (slot i plays team i / players_per_team,
+// position i % players_per_team); returns 0 on success, or -1 with errno
+// from the pipe() or fork() that failed
+int   player_pool_start(int nplayers);
+
+// Number of processes in the pool (0 if it is not running)
+int   player_pool_size(void);
+
+// Reset every player for a new match and wait until all have done so
+int   player_pool_reset(unsigned int seed);
+
+pid_t player_pool_pid(int slot);
+int   player_pool_energy_fd(int slot);   // Referee's read end of the slot's pipe
+
+// Ask every player to exit and reap them
+void  player_pool_stop(void);
+
+// Delivery probe for the round result signals (used by tug_stress). When
+// enabled before player_pool_start, every player counts the SIG_WIN_ROUND
+// and SIG_LOSE_ROUND signals it handles and stamps the last one with
+// CLOCK_MONOTONIC, in a block shared with the referee.
+typedef struct {
+    int64_t  last_ns;
+    uint32_t count;
+    uint32_t pad;
+} PlayerProbe;
+
+void  player_pool_enable_probe(int enable);
+const volatile PlayerProbe *player_pool_probe(int slot);   // NULL if not enabled
+
+#endif  // PLAYER_POOL_H
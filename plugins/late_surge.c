@@ -0,0 +1,22 @@
+/*
+ * Example effort strategy plugin (see strategy.h)
+ * Build: make plugins
+ * Use:   ./tug_of_war --headless --strategy 1=./plugins/late_surge.so
+ *
+ * Players pull at 80% for the first half of each round's likely length,
+ * then the strongest half of the team surges while the weaker half keeps
+ * pulling normally.
+ */
+#include "../strategy.h"
+
+void tug_strategy(const StrategyTeam *team, float *exertion) {
+    int surge = team->elapsed >= 5.0f * (float)team->round_number
+             || team->lead <= -0.5f * team->round_win_threshold;
+    int half = team->players / 2;
+    for (int p = 0; p < team->players; p++) {
+        if (!surge)
+            exertion[p] = 0.8f;
+        else
+            exertion[p] = team->position[p] > half ? 1.6f : 1.0f;
+    }
+}
@@ -0,0 +1,25 @@
+// pool.h
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+// ----------------------------------------------------------
+// Fork-based worker pool for independent jobs (headless matches,
+// sweep points, tournament games). Each worker is a forked process
+// pinned to its own core; workers claim job numbers from a shared
+// counter and write fixed-size results into a shared array, which is
+// copied back into `results` once every worker has exited.
+// ----------------------------------------------------------
+
+// Runs one job; result points at this job's result_size bytes
+typedef void (*PoolJobFn)(int job, void *result, void *ctx);
+
+// Returns 0 when every job ran, -1 if a worker could not be started or died
+int pool_run(int njobs, size_t result_size, void *results,
+             int nworkers, PoolJobFn fn, void *ctx);
+
+// Number of online CPUs (at least 1)
+int pool_default_workers(void);
+
+#endif  // POOL_H
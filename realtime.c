@@ -0,0 +1,162 @@
+// Low-jitter placement of the referee (see realtime.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "realtime.h"
+#include "log.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+// Lateness histogram: 1 us per bucket, later ticks go in the last one
+#define LATE_BUCKETS 10000
+
+static int pinned_cpu = -1;
+static int fifo = 0;                    // SCHED_FIFO was granted
+static int locked = 0;                  // mlockall succeeded
+static cpu_set_t others;                // Every usable core but the referee's
+static int have_others = 0;
+static int atfork_registered = 0;
+
+static uint32_t late_hist[LATE_BUCKETS];
+static long     late_count = 0;
+static long     overrun_count = 0;
+static int64_t  late_max_ns = 0;
+
+// Forked children (players, front end, what-if branches) leave the core
+static void atfork_child(void) {
+    if (pinned_cpu >= 0 && have_others)
+        sched_setaffinity(0, sizeof(others), &others);
+    pinned_cpu = -1;
+}
+
+int realtime_enter(int cpu) {
+    cpu_set_t all;
+    if (sched_getaffinity(0, sizeof(all), &all) != 0) {
+        perror("sched_getaffinity");
+        return -1;
+    }
+    if (cpu < 0 || cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &all)) {
+        fprintf(stderr, "CPU %d is not available to this process\n", cpu);
+        return -1;
+    }
+    others = all;
+    CPU_CLR(cpu, &others);
+    have_others = CPU_COUNT(&others) > 0;
+
+    cpu_set_t mine;
+    CPU_ZERO(&mine);
+    CPU_SET(cpu, &mine);
+    if (sched_setaffinity(0, sizeof(mine), &mine) != 0) {
+        perror("sched_setaffinity");
+        return -1;
+    }
+    pinned_cpu = cpu;
+    if (!atfork_registered) {
+        pthread_atfork(NULL, NULL, atfork_child);
+        atfork_registered = 1;
+    }
+
+    struct sched_param sp = { .sched_priority = REALTIME_PRIORITY };
+    fifo = sched_setscheduler(0, SCHED_FIFO | SCHED_RESET_ON_FORK, &sp) == 0;
+    if (!fifo)
+        LOG_WARN("SCHED_FIFO not permitted (%s); the referee keeps the normal policy\n",
+                 strerror(errno));
+
+    // Only what is mapped now: locking future mappings too would make
+    // later allocations fail once RLIMIT_MEMLOCK is reached
+    locked = mlockall(MCL_CURRENT) == 0;
+    if (!locked)
+        LOG_WARN("mlockall failed (%s); memory is prefaulted but not locked\n",
+                 strerror(errno));
+    if (!have_others)
+        LOG_WARN("Only CPU %d is available; players and the front end share it\n", cpu);
+
+    LOG_INFO("Referee pinned to CPU %d%s%s\n", cpu,
+             fifo ? ", SCHED_FIFO" : "", locked ? ", memory locked" : "");
+    return 0;
+}
+
+int realtime_cpu(void) {
+    return pinned_cpu;
+}
+
+void realtime_move(pid_t pid) {
+    if (pinned_cpu >= 0 && have_others && pid > 0)
+        sched_setaffinity(pid, sizeof(others), &others);
+}
+
+void realtime_leave(void) {
+    if (pinned_cpu < 0)
+        return;
+    if (have_others)
+        sched_setaffinity(0, sizeof(others), &others);
+    struct sched_param sp = { .sched_priority = 0 };
+    sched_setscheduler(0, SCHED_OTHER, &sp);
+}
+
+void realtime_prefault(void *addr, size_t len) {
+    if (pinned_cpu < 0 || !addr || len == 0)
+        return;
+    // Write each page back to itself: only the referee writes this memory
+    // and the match has not started yet
+    long page = sysconf(_SC_PAGESIZE);
+    volatile char *p = addr;
+    for (size_t off = 0; off < len; off += (size_t)page)
+        p[off] = p[off];
+    p[len - 1] = p[len - 1];
+    if (locked)
+        mlock(addr, len);
+}
+
+void realtime_tick_late(int overran, int64_t late_ns) {
+    if (overran) {
+        overrun_count++;
+        return;
+    }
+    if (late_ns < 0)
+        late_ns = 0;                // Woken early by a signal
+    int64_t us = late_ns / 1000;
+    late_hist[us < LATE_BUCKETS ? us : LATE_BUCKETS - 1]++;
+    late_count++;
+    if (late_ns > late_max_ns)
+        late_max_ns = late_ns;
+}
+
+// Upper edge (us) of the bucket holding the q quantile
+static int late_percentile_us(double q) {
+    long rank = (long)(q * (double)late_count);
+    if (rank >= late_count)
+        rank = late_count - 1;
+    long seen = 0;
+    for (int b = 0; b < LATE_BUCKETS; b++) {
+        seen += late_hist[b];
+        if (seen > rank)
+            return b + 1;
+    }
+    return LATE_BUCKETS;
+}
+
+void realtime_report(void) {
+    if (late_count == 0)
+        return;
+    char placement[64];
+    if (pinned_cpu >= 0)
+        snprintf(placement, sizeof(placement), "on CPU %d%s%s", pinned_cpu,
+                 fifo ? ", SCHED_FIFO" : "", locked ? ", memory locked" : "");
+    else
+        snprintf(placement, sizeof(placement), "not pinned");
+    LOG_INFO("Tick lateness over %ld ticks: p50 <%d us, p99 <%d us, "
+             "max %.1f us, %ld overran (referee %s)\n",
+             late_count, late_percentile_us(0.5), late_percentile_us(0.99),
+             (double)late_max_ns / 1e3, overrun_count, placement);
+
+    memset(late_hist, 0, sizeof(late_hist));
+    late_count = 0;
+    overrun_count = 0;
+    late_max_ns = 0;
+}
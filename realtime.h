@@ -0,0 +1,51 @@
+// realtime.h
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// ----------------------------------------------------------
+// Low-jitter placement for live matches. The referee can be pinned to
+// one core and run at SCHED_FIFO (when the user may; otherwise it keeps
+// the normal policy), with its memory locked and the shared segment and
+// match state faulted in before the first tick. Players, the front end
+// and helper threads move to the other cores: running processes through
+// realtime_move, processes forked later automatically (the FIFO policy
+// is reset on fork). Every live match also reports how late the
+// referee woke up for its ticks, pinned or not, so the two can be
+// compared.
+// ----------------------------------------------------------
+
+// Real-time priority of the pinned referee (low, so kernel threads still
+// preempt it)
+#define REALTIME_PRIORITY 10
+
+// Pin the calling thread to cpu, then try SCHED_FIFO and mlockall.
+// Returns 0, or -1 if the core cannot be used.
+int  realtime_enter(int cpu);
+
+// Core of the pinned referee, or -1
+int  realtime_cpu(void);
+
+// Move a running process off the referee's core
+void realtime_move(pid_t pid);
+
+// Take the calling thread off the referee's core and back to the normal
+// policy (for threads the referee starts after realtime_enter)
+void realtime_leave(void);
+
+// Fault in every page of [addr, addr + len) and lock it when permitted
+// (no-op unless pinned)
+void realtime_prefault(void *addr, size_t len);
+
+// Record how late (real nanoseconds) the referee woke up for a tick.
+// overran: the tick's deadline had passed before it could sleep (slow
+// work), so it is counted but not part of the lateness figures.
+void realtime_tick_late(int overran, int64_t late_ns);
+
+// Log the tick lateness recorded since the last report and start over
+void realtime_report(void);
+
+#endif  // REALTIME_H
@@ -0,0 +1,341 @@
+// Offscreen rendering to PPM frame sequences (see render.h)
+#define _POSIX_C_SOURCE 200809L
+
+#include "render.h"
+#include "scene.h"
+#include "game.h"
+#include "pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// Frames drawn by one pool job
+#define RENDER_BATCH 32
+
+// Text is the 5x8 font below, each font pixel drawn as a square this big
+#define TEXT_SCALE 2
+
+int render_active = 0;
+
+static char dir_path[4096];
+static int frame_width = 0;
+static int frame_height = 0;
+static int render_workers = 1;
+static int atfork_registered = 0;
+static int write_failed = 0;
+
+// Recorded ticks of the current match
+static SharedState *frames = NULL;
+static int nframes = 0;
+static int frames_capacity = 0;
+static long match_id = 0;
+
+// ---------------------------------------------------------------------
+// 5x8 font for ASCII 32..126: five columns per glyph, bit 0 the top row,
+// row 6 on the baseline and bit 7 the descender row
+// ---------------------------------------------------------------------
+static const uint8_t font5x8[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00},
+    {0x14,0x7F,0x14,0x7F,0x14}, {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62},
+    {0x36,0x49,0x56,0x20,0x50}, {0x00,0x00,0x07,0x00,0x00}, {0x00,0x1C,0x22,0x41,0x00},
+    {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x80,0x60,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00},
+    {0x20,0x10,0x08,0x04,0x02}, {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00},
+    {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33}, {0x18,0x14,0x12,0x7F,0x10},
+    {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x24,0x00,0x00},
+    {0x00,0x80,0x64,0x00,0x00}, {0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14},
+    {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06}, {0x3E,0x41,0x5D,0x59,0x4E},
+    {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01},
+    {0x3E,0x41,0x41,0x51,0x73}, {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00},
+    {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, {0x7F,0x40,0x40,0x40,0x40},
+    {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46},
+    {0x26,0x49,0x49,0x49,0x32}, {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F},
+    {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, {0x63,0x14,0x08,0x14,0x63},
+    {0x03,0x04,0x78,0x04,0x03}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04},
+    {0x80,0x80,0x80,0x80,0x80}, {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78},
+    {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28}, {0x38,0x44,0x44,0x48,0x7F},
+    {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x18,0xA4,0xA4,0xA4,0x7C},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x40,0x80,0x84,0x7D,0x00},
+    {0x7F,0x10,0x28,0x44,0x00}, {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78},
+    {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, {0xFC,0x24,0x24,0x24,0x18},
+    {0x18,0x24,0x24,0x24,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+    {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C},
+    {0x3C,0x40,0x30,0x40,0x3C}, {0x44,0x28,0x10,0x28,0x44}, {0x1C,0xA0,0xA0,0xA0,0x7C},
+    {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00}, {0x00,0x00,0x7F,0x00,0x00},
+    {0x00,0x41,0x36,0x08,0x00}, {0x08,0x04,0x08,0x10,0x08}
+};
+
+// ---------------------------------------------------------------------
+// CPU rasterizer: a SceneCanvas on an RGB buffer. Window coordinates
+// have y up; buffer rows are stored top first, as PPM wants them.
+// Pixels are covered when their centre is inside a shape, and wide lines
+// are widened across their minor axis, like aliased GL lines.
+// ---------------------------------------------------------------------
+typedef struct {
+    uint8_t *rgb;
+    int width, height;
+    uint8_t color[3];
+    float line_width;
+} Raster;
+
+static inline uint8_t to_byte(float v) {
+    return v <= 0.0f ? 0 : v >= 1.0f ? 255 : (uint8_t)(v * 255.0f + 0.5f);
+}
+
+// Fill pixel columns [x0, x1) of window row y
+static void fill_span(Raster *r, int y, int x0, int x1) {
+    if (y < 0 || y >= r->height)
+        return;
+    if (x0 < 0)
+        x0 = 0;
+    if (x1 > r->width)
+        x1 = r->width;
+    uint8_t *px = r->rgb + ((size_t)(r->height - 1 - y) * r->width + x0) * 3;
+    for (int x = x0; x < x1; x++, px += 3) {
+        px[0] = r->color[0];
+        px[1] = r->color[1];
+        px[2] = r->color[2];
+    }
+}
+
+static void raster_color(void *ctx, float red, float green, float blue) {
+    Raster *r = ctx;
+    r->color[0] = to_byte(red);
+    r->color[1] = to_byte(green);
+    r->color[2] = to_byte(blue);
+}
+
+static void raster_line_width(void *ctx, float width) {
+    ((Raster *)ctx)->line_width = width < 1.0f ? 1.0f : width;
+}
+
+// Convex polygon, one span per row between its left and right edges
+static void raster_polygon(void *ctx, const float *xy, int n) {
+    Raster *r = ctx;
+    float ymin = xy[1], ymax = xy[1];
+    for (int i = 1; i < n; i++) {
+        if (xy[2 * i + 1] < ymin) ymin = xy[2 * i + 1];
+        if (xy[2 * i + 1] > ymax) ymax = xy[2 * i + 1];
+    }
+    int row0 = (int)ceilf(ymin - 0.5f);
+    int row1 = (int)floorf(ymax - 0.5f);
+    if (row0 < 0)
+        row0 = 0;
+    if (row1 > r->height - 1)
+        row1 = r->height - 1;
+
+    for (int row = row0; row <= row1; row++) {
+        float yc = (float)row + 0.5f;
+        float left = INFINITY, right = -INFINITY;
+        for (int i = 0; i < n; i++) {
+            float x0 = xy[2 * i], y0 = xy[2 * i + 1];
+            float x1 = xy[2 * ((i + 1) % n)], y1 = xy[2 * ((i + 1) % n) + 1];
+            if ((yc < y0) == (yc < y1))
+                continue;           // Edge does not cross this row
+            float x = x0 + (yc - y0) / (y1 - y0) * (x1 - x0);
+            if (x < left) left = x;
+            if (x > right) right = x;
+        }
+        if (left <= right)
+            fill_span(r, row, (int)ceilf(left - 0.5f), (int)floorf(right - 0.5f) + 1);
+    }
+}
+
+static void raster_line(void *ctx, float x0, float y0, float x1, float y1) {
+    Raster *r = ctx;
+    float half = 0.5f * r->line_width;
+    float ox = 0.0f, oy = 0.0f;
+    if (fabsf(x1 - x0) >= fabsf(y1 - y0))
+        oy = half;                  // x-major: widen vertically
+    else
+        ox = half;
+    float quad[8] = {
+        x0 - ox, y0 - oy,  x1 - ox, y1 - oy,
+        x1 + ox, y1 + oy,  x0 + ox, y0 + oy
+    };
+    raster_polygon(ctx, quad, 4);
+}
+
+static void raster_text(void *ctx, float x, float y, const char *text) {
+    Raster *r = ctx;
+    int pen = (int)lrintf(x);
+    int base = (int)lrintf(y);
+    for (; *text; text++) {
+        unsigned char ch = (unsigned char)*text;
+        if (ch < 32 || ch > 126)
+            ch = '?';
+        const uint8_t *glyph = font5x8[ch - 32];
+
+        // Proportional: skip empty columns on both sides
+        int first = 0, last = 4;
+        while (first <= last && glyph[first] == 0) first++;
+        while (last >= first && glyph[last] == 0) last--;
+        if (first > last) {
+            pen += 3 * TEXT_SCALE;  // Space
+            continue;
+        }
+        for (int col = first; col <= last; col++) {
+            int gx = pen + (col - first) * TEXT_SCALE;
+            for (int row = 0; row < 8; row++) {
+                if (!(glyph[col] & (1u << row)))
+                    continue;
+                int gy = base + (6 - row) * TEXT_SCALE;
+                for (int k = 0; k < TEXT_SCALE; k++)
+                    fill_span(r, gy + k, gx, gx + TEXT_SCALE);
+            }
+        }
+        pen += (last - first + 2) * TEXT_SCALE;
+    }
+}
+
+void render_frame(const SharedState *st, uint8_t *rgb, int width, int height) {
+    Raster r = { rgb, width, height, {0, 0, 0}, 1.0f };
+    SceneCanvas canvas = {
+        &r, raster_color, raster_line_width, raster_line, raster_polygon, raster_text
+    };
+    memset(rgb, 255, (size_t)width * height * 3);  // White, like glClearColor
+    scene_draw(&canvas, st, width, height);
+}
+
+// ---------------------------------------------------------------------
+// Frame files, rendered in batches on the worker pool
+// ---------------------------------------------------------------------
+static int write_ppm(const char *path, const uint8_t *rgb, int width, int height) {
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return errno;
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+    size_t bytes = (size_t)width * height * 3;
+    int err = fwrite(rgb, 1, bytes, f) == bytes ? 0 : errno;
+    if (fclose(f) != 0 && err == 0)
+        err = errno;
+    return err;
+}
+
+typedef struct {
+    int total;                  // Frames to write, including the result screen
+} RenderBatch;
+
+// Pool job: draw and write frames [job * RENDER_BATCH, ...); the result
+// is 0 or the errno of the first failed write
+static void render_job(int job, void *result, void *ctx) {
+    const RenderBatch *batch = ctx;
+    int *err = result;
+    *err = 0;
+    uint8_t *rgb = malloc((size_t)frame_width * frame_height * 3);
+    if (!rgb) {
+        *err = ENOMEM;
+        return;
+    }
+    int end = (job + 1) * RENDER_BATCH;
+    if (end > batch->total)
+        end = batch->total;
+    for (int i = job * RENDER_BATCH; i < end && *err == 0; i++) {
+        // Frames past the last tick repeat its state
+        const SharedState *st = &frames[i < nframes ? i : nframes - 1];
+        char path[sizeof(dir_path) + 64];
+        render_frame(st, rgb, frame_width, frame_height);
+        snprintf(path, sizeof(path), "%s/match%ld_%06d.ppm", dir_path, match_id, i);
+        *err = write_ppm(path, rgb, frame_width, frame_height);
+    }
+    free(rgb);
+}
+
+// Render the recorded ticks of the current match and forget them
+static void flush_frames(void) {
+    if (nframes == 0)
+        return;
+    RenderBatch batch = { nframes };
+    if (frames[nframes - 1].game_ended)
+        batch.total += RENDER_END_SECONDS * TICKS_PER_SECOND;
+    int jobs = (batch.total + RENDER_BATCH - 1) / RENDER_BATCH;
+    int *errs = calloc((size_t)jobs, sizeof(int));
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int status = errs ? pool_run(jobs, sizeof(int), errs, render_workers, render_job, &batch) : -1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    for (int j = 0; status == 0 && j < jobs; j++) {
+        if (errs[j] != 0) {
+            fprintf(stderr, "Render: %s/match%ld: %s\n", dir_path, match_id, strerror(errs[j]));
+            status = -1;
+        }
+    }
+    if (status == 0)
+        printf("Render: %d frames in %s/match%ld_*.ppm (%.1f s, %.0f frames/s)\n",
+               batch.total, dir_path, match_id, secs, secs > 0.0 ? batch.total / secs : 0.0);
+    else
+        write_failed = 1;
+    free(errs);
+    nframes = 0;
+}
+
+static void atfork_child(void) {
+    render_active = 0;
+}
+
+int render_open(const char *dir, int width, int height, int workers) {
+    if (width < 1 || height < 1) {
+        fprintf(stderr, "Render: bad frame size %dx%d\n", width, height);
+        return -1;
+    }
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        perror(dir);
+        return -1;
+    }
+    if (!atfork_registered) {
+        pthread_atfork(NULL, NULL, atfork_child);
+        atfork_registered = 1;
+    }
+    snprintf(dir_path, sizeof(dir_path), "%s", dir);
+    frame_width = width;
+    frame_height = height;
+    render_workers = workers < 1 ? 1 : workers;
+    write_failed = 0;
+    nframes = 0;
+    render_active = 1;
+    return 0;
+}
+
+void render_set_match(long id) {
+    if (!render_active)
+        return;
+    flush_frames();
+    match_id = id;
+}
+
+void render_capture(void) {
+    if (nframes == frames_capacity) {
+        int grown_capacity = frames_capacity ? 2 * frames_capacity : 1024;
+        SharedState *grown = realloc(frames, (size_t)grown_capacity * sizeof(SharedState));
+        if (!grown) {
+            perror("render frames");
+            exit(EXIT_FAILURE);
+        }
+        frames = grown;
+        frames_capacity = grown_capacity;
+    }
+    frames[nframes++] = *shared_state;
+}
+
+int render_close(void) {
+    if (!render_active)
+        return 0;
+    flush_frames();
+    render_active = 0;
+    free(frames);
+    frames = NULL;
+    frames_capacity = 0;
+    return write_failed ? -1 : 0;
+}
@@ -0,0 +1,46 @@
+// render.h
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <stdint.h>
+#include "state.h"     // SharedState
+
+// ----------------------------------------------------------
+// Offscreen rendering of matches to PPM frame sequences, for machines
+// without a display or GPU. While a render directory is open the referee
+// records a copy of the shared state after every tick; once the match is
+// over, the recorded ticks are drawn by the same scene code as the
+// OpenGL window (scene.h) on a small CPU rasterizer, in batches spread
+// over the worker pool, one frame per tick (TICKS_PER_SECOND frames per
+// game second) plus RENDER_END_SECONDS of the result screen.
+//
+// Frames are written as DIR/match<id>_<frame>.ppm, with id the seed of a
+// headless match or the number of a live one, e.g.
+//   ffmpeg -framerate 10 -i DIR/match42_%06d.ppm match42.mp4
+// ----------------------------------------------------------
+
+#define RENDER_END_SECONDS 5
+
+// Set while a render directory is open in this process; the referee
+// tests it before calling render_capture. Forked children start with it
+// cleared.
+extern int render_active;
+
+// Record matches from now on and render them into dir (created if
+// needed) as width x height frames on `workers` processes
+int  render_open(const char *dir, int width, int height, int workers);
+
+// Render the ticks recorded so far, then record the match with this id
+void render_set_match(long id);
+
+// Record shared_state as the next frame
+void render_capture(void);
+
+// Render what is left and stop recording. Returns 0 if every frame
+// reached its file.
+int  render_close(void);
+
+// Draw one frame of st into rgb (width * height * 3 bytes, top row first)
+void render_frame(const SharedState *st, uint8_t *rgb, int width, int height);
+
+#endif  // RENDER_H
@@ -0,0 +1,196 @@
+// Match picture for every graphical front end (see scene.h)
+#include "scene.h"
+#include <stdio.h>
+#include <math.h>
+
+// ---------------------------------------------------------------------
+// Global drawing parameters
+// ---------------------------------------------------------------------
+static const float team1_base_x = 0.25f;  // Left side
+static const float team2_base_x = 0.75f;  // Right side
+static const float rope_center_x = 0.50f; // Middle of the screen
+
+// Team colors
+static const float team_colors[NUM_TEAMS][3] = {
+    {0.0f, 0.3f, 1.0f}, // Team 1: Blue
+    {0.0f, 0.8f, 0.0f}  // Team 2: Green
+};
+
+#define HEAD_SEGMENTS 20
+
+// ---------------------------------------------------------------------
+// draw_head
+//  A filled circle above the body
+// ---------------------------------------------------------------------
+static void draw_head(const SceneCanvas *c, float x, float y, float radius) {
+    float xy[2 * HEAD_SEGMENTS];
+    for (int i = 0; i < HEAD_SEGMENTS; i++) {
+        float theta = 2.0f * 3.14159f * i / (float)HEAD_SEGMENTS;
+        xy[2 * i]     = x + cosf(theta) * radius;
+        xy[2 * i + 1] = y + sinf(theta) * radius;
+    }
+    c->polygon(c->ctx, xy, HEAD_SEGMENTS);
+}
+
+// ---------------------------------------------------------------------
+// draw_player
+//  Draws a standing stick figure
+// ---------------------------------------------------------------------
+static void draw_player(const SceneCanvas *c, float x, float y, float scale) {
+    float head_radius = 10.0f * scale;
+    float body_height = 40.0f * scale;
+    float limb_length = 20.0f * scale;
+
+    // Head
+    draw_head(c, x, y + body_height, head_radius);
+
+    // Body line
+    c->line(c->ctx, x, y + body_height, x, y);
+
+    // Arms
+    c->line(c->ctx, x, y + body_height * 0.7f, x - limb_length, y + body_height * 0.5f);
+    c->line(c->ctx, x, y + body_height * 0.7f, x + limb_length, y + body_height * 0.5f);
+
+    // Legs
+    c->line(c->ctx, x, y, x - limb_length * 0.8f, y - limb_length);
+    c->line(c->ctx, x, y, x + limb_length * 0.8f, y - limb_length);
+}
+
+// ---------------------------------------------------------------------
+// draw_player_fallen
+//  Draws a "fallen" player with a gray circle + red cross
+// ---------------------------------------------------------------------
+static void draw_player_fallen(const SceneCanvas *c, float x, float y, float scale) {
+    float head_radius = 10.0f * scale;
+    float body_height = 40.0f * scale;
+    float head_y = y + body_height;
+
+    // Gray head
+    c->color(c->ctx, 0.5f, 0.5f, 0.5f);
+    draw_head(c, x, head_y, head_radius);
+
+    // Red cross on head
+    c->color(c->ctx, 1.0f, 0.0f, 0.0f);
+    c->line(c->ctx, x - head_radius, head_y + head_radius, x + head_radius, head_y - head_radius);
+    c->line(c->ctx, x - head_radius, head_y - head_radius, x + head_radius, head_y + head_radius);
+
+    // Short horizontal line for the body (lying down)
+    c->color(c->ctx, 0.5f, 0.5f, 0.5f);
+    c->line(c->ctx, x - 10.0f * scale, y + body_height * 0.5f,
+                    x + 10.0f * scale, y + body_height * 0.5f);
+}
+
+// ---------------------------------------------------------------------
+// draw_team
+//  A team's players with their energy and effort labels. Team 1 stands
+//  in reverse position order left of the rope, labels on the right of
+//  each player; team 2 stands 1 2 3 4, labels on the left. The shared
+//  state holds the first PLAYERS_PER_TEAM players of larger rosters, so
+//  each one stands at its rank among those (by position, then index)
+//  rather than at its position in the whole team.
+// ---------------------------------------------------------------------
+static int drawn_rank(const Player *row, int p) {
+    int rank = 0;
+    for (int q = 0; q < PLAYERS_PER_TEAM; q++) {
+        if (row[q].position < row[p].position ||
+            (row[q].position == row[p].position && q < p))
+            rank++;
+    }
+    return rank;
+}
+
+static void draw_team(const SceneCanvas *c, const SharedState *st, int t,
+                      float base_x, float base_y) {
+    for (int p = 0; p < PLAYERS_PER_TEAM; p++) {
+        const Player *pl = &st->players[t][p];
+        float posIndex = (float)drawn_rank(st->players[t], p);
+        float offset = (t == 0 ? 1.5f - posIndex : posIndex - 1.5f) * 60.0f;
+        float px = base_x + offset;
+
+        // Determine scale based on energy
+        float scale = 0.6f + (pl->energy / 100.0f) * 0.4f;
+        if (pl->recovering) {
+            draw_player_fallen(c, px, base_y, scale);
+        } else {
+            c->color(c->ctx, team_colors[t][0], team_colors[t][1], team_colors[t][2]);
+            draw_player(c, px, base_y, scale);
+        }
+
+        float label_x = t == 0 ? px + 15 : px - 65;
+        float label_y = base_y + 70;
+        char energy_label[12];
+        snprintf(energy_label, sizeof(energy_label), "E %.1f", pl->energy);
+        char effort_label[12];
+        snprintf(effort_label, sizeof(effort_label), "F%.1f", pl->effort);
+        c->color(c->ctx, 0.0f, 0.0f, 0.0f);
+        c->text(c->ctx, label_x, label_y, energy_label);
+        c->color(c->ctx, 0.2f, 0.2f, 0.2f);
+        c->text(c->ctx, label_x, label_y - 20, effort_label);
+    }
+}
+
+// ---------------------------------------------------------------------
+// scene_draw
+// ---------------------------------------------------------------------
+void scene_draw(const SceneCanvas *c, const SharedState *st, int width, int height) {
+    // --- End-of-match drawing ---
+    if (st->game_ended == 1) {
+        char winner_str[80];
+        sprintf(winner_str, "TEAM %d IS THE WINNER!", st->final_winner + 1);
+        char score_str[100];
+        sprintf(score_str, "Final Score: Team1=%d  |  Team2=%d",
+                st->team_round_wins[0], st->team_round_wins[1]);
+        c->color(c->ctx, 1.0f, 0.0f, 0.0f);
+        c->text(c->ctx, width * 0.4f, height * 0.55f, winner_str);
+        c->color(c->ctx, 0.0f, 0.0f, 0.0f);
+        c->text(c->ctx, width * 0.4f, height * 0.55f - 40, score_str);
+        return;
+    }
+
+    // --- Normal Rendering ---
+    float max_pixels = 0.25f * width;
+    float rope_offset = st->rope_threshold > 0.0f
+                      ? -((st->rope_position / st->rope_threshold) * max_pixels) : 0.0f;
+    float current_rope_center = (rope_center_x * width) - rope_offset;
+    float rope_y = 0.5f * height;
+
+    // Draw the rope and center-line
+    c->color(c->ctx, 0.6f, 0.3f, 0.1f);
+    c->line_width(c->ctx, 5.0f);
+    c->line(c->ctx, current_rope_center - 100, rope_y, current_rope_center + 100, rope_y);
+    c->color(c->ctx, 1.0f, 0.0f, 0.0f);
+    c->line(c->ctx, 0.5f * width, rope_y - 20, 0.5f * width, rope_y + 20);
+
+    float base_y = rope_y - 50.0f;
+    draw_team(c, st, 0, (team1_base_x * width) - rope_offset, base_y);
+    draw_team(c, st, 1, (team2_base_x * width) - rope_offset, base_y);
+
+    // --- Draw Total Effort Labels Under Each Team ---
+    char team1_effort_label[50];
+    char team2_effort_label[50];
+    snprintf(team1_effort_label, sizeof(team1_effort_label), "Team 1 Total Effort: %.1f", st->team_efforts[0]);
+    snprintf(team2_effort_label, sizeof(team2_effort_label), "Team 2 Total Effort: %.1f", st->team_efforts[1]);
+    c->text(c->ctx, (team1_base_x * width) - 50, base_y - 40, team1_effort_label);
+    c->text(c->ctx, (team2_base_x * width) - 50, base_y - 40, team2_effort_label);
+
+    // --- Draw header information ---
+    char header[160];
+    int len = snprintf(header, sizeof(header),
+             "Time: %d sec | Round: %d | Team1 Wins: %d | Team2 Wins: %d | Rope: %.1f/%.1f",
+             st->elapsed_seconds, st->round_number, st->team_round_wins[0],
+             st->team_round_wins[1], st->rope_position, st->rope_threshold);
+    if (st->time_warp > 0.0f && st->time_warp != 1.0f && len > 0 && len < (int)sizeof(header))
+        snprintf(header + len, sizeof(header) - len, " | Warp: %.2fx", st->time_warp);
+    c->color(c->ctx, 0.0f, 0.0f, 0.0f);
+    c->text(c->ctx, 20, height - 30, header);
+
+    // Live win odds from the referee's what-if branches
+    if (st->whatif_branches > 0) {
+        char odds[96];
+        snprintf(odds, sizeof(odds), "P(win): Team1 %.0f%% | Team2 %.0f%% (%d branches)",
+                 st->win_probability[0] * 100.0f,
+                 st->win_probability[1] * 100.0f,
+                 st->whatif_branches);
+        c->text(c->ctx, 20, height - 55, odds);
+    }
+}
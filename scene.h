@@ -0,0 +1,29 @@
+// scene.h
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "state.h"     // SharedState
+
+// ----------------------------------------------------------
+// The match picture shared by the OpenGL window and the offscreen
+// renderer: rope, stick-figure players with their labels, team efforts,
+// the header and the final result. It is drawn through a SceneCanvas in
+// window coordinates (origin bottom left, y up, as gluOrtho2D sets it),
+// so the same code runs on GL or on a CPU framebuffer.
+// ----------------------------------------------------------
+
+typedef struct {
+    void *ctx;
+    void (*color)(void *ctx, float r, float g, float b);
+    void (*line_width)(void *ctx, float width);
+    void (*line)(void *ctx, float x0, float y0, float x1, float y1);
+    // Filled convex polygon of n points (xy holds x0, y0, x1, y1, ...)
+    void (*polygon)(void *ctx, const float *xy, int n);
+    // Text with its baseline starting at (x, y)
+    void (*text)(void *ctx, float x, float y, const char *text);
+} SceneCanvas;
+
+// Draw one frame of st on a width x height canvas (already cleared to white)
+void scene_draw(const SceneCanvas *canvas, const SharedState *st, int width, int height);
+
+#endif  // SCENE_H
@@ -0,0 +1,183 @@
+// SharedState segment and its sequence lock (see shm.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "shm.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+SharedSegment *shared_segment = NULL;
+
+// Retries before shm_read gives up waiting for an even generation
+#define SHM_READ_MAX_TRIES 100000
+
+static char owned_name[256];    // Named segment this process created, if any
+
+// shm_open names start with a slash; accept them with or without
+static void object_name(const char *name, char *buf, size_t len) {
+    snprintf(buf, len, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+// Writer of an existing named segment: its pid, 0 if the object is not a
+// segment of this layout (or cannot be read)
+static pid_t segment_writer(const char *path) {
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0)
+        return 0;
+    struct stat st;
+    pid_t pid = 0;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(SharedHeader)) {
+        void *map_ptr = mmap(NULL, sizeof(SharedHeader), PROT_READ, MAP_SHARED, fd, 0);
+        if (map_ptr != MAP_FAILED) {
+            const SharedHeader *hdr = map_ptr;
+            if (memcmp(hdr->magic, SHM_MAGIC, sizeof(hdr->magic)) == 0)
+                pid = hdr->writer_pid;
+            munmap(map_ptr, sizeof(SharedHeader));
+        }
+    }
+    close(fd);
+    return pid;
+}
+
+int shm_create(const char *name) {
+    int fd = -1;
+    char path[256];
+    int flags = MAP_SHARED | MAP_ANONYMOUS;
+    if (name) {
+        object_name(name, path, sizeof(path));
+        fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 && errno == EEXIST) {
+            // Take over the segment of a referee that died without removing
+            // it; never one that is still being written
+            pid_t writer = segment_writer(path);
+            if (writer <= 0) {
+                fprintf(stderr, "%s exists and is not a tug-of-war segment "
+                        "(remove /dev/shm%s if it is left over)\n", path, path);
+                return -1;
+            }
+            if (kill(writer, 0) == 0 || errno == EPERM) {
+                fprintf(stderr, "%s is in use by the referee with pid %d\n",
+                        path, (int)writer);
+                return -1;
+            }
+            fprintf(stderr, "Removing stale segment %s of referee %d\n", path, (int)writer);
+            shm_unlink(path);
+            fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0644);
+        }
+        if (fd < 0 || ftruncate(fd, sizeof(SharedSegment)) != 0) {
+            perror("shm_open failed");
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+        flags = MAP_SHARED;
+    }
+    void *map_ptr = mmap(NULL, sizeof(SharedSegment), PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (fd >= 0)
+        close(fd);
+    if (map_ptr == MAP_FAILED) {
+        perror("mmap failed");
+        return -1;
+    }
+
+    SharedSegment *seg = map_ptr;
+    memset(seg, 0, sizeof(*seg));
+    seg->header.version = SHM_LAYOUT_VERSION;
+    seg->header.layout_size = sizeof(SharedSegment);
+    seg->header.writer_pid = (int32_t)getpid();
+    // The magic goes last: attachers ignore a segment until it is set up
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(seg->header.magic, SHM_MAGIC, sizeof(seg->header.magic));
+
+    shared_segment = seg;
+    shared_state = &seg->state;
+    if (name)
+        snprintf(owned_name, sizeof(owned_name), "%s", path);
+    else
+        owned_name[0] = '\0';
+    return 0;
+}
+
+int shm_attach(const char *name) {
+    char path[256];
+    object_name(name, path, sizeof(path));
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedSegment)) {
+        fprintf(stderr, "%s: segment too small for this build\n", path);
+        close(fd);
+        return -1;
+    }
+    void *map_ptr = mmap(NULL, sizeof(SharedSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map_ptr == MAP_FAILED) {
+        perror("mmap failed");
+        return -1;
+    }
+
+    SharedSegment *seg = map_ptr;
+    if (memcmp(seg->header.magic, SHM_MAGIC, sizeof(seg->header.magic)) != 0 ||
+        seg->header.version != SHM_LAYOUT_VERSION ||
+        seg->header.layout_size != sizeof(SharedSegment)) {
+        fprintf(stderr, "%s: not a compatible tug-of-war segment\n", path);
+        munmap(map_ptr, sizeof(SharedSegment));
+        return -1;
+    }
+    shared_segment = seg;
+    shared_state = &seg->state;   // Read-only: use shm_read()
+    owned_name[0] = '\0';
+    return 0;
+}
+
+void shm_release(void) {
+    if (!shared_segment)
+        return;
+    munmap(shared_segment, sizeof(SharedSegment));
+    shared_segment = NULL;
+    shared_state = NULL;
+    if (owned_name[0]) {
+        shm_unlink(owned_name);
+        owned_name[0] = '\0';
+    }
+}
+
+// ---------------------------------------------------------------------
+// Sequence lock
+// ---------------------------------------------------------------------
+void shm_write_begin(void) {
+    __atomic_add_fetch(&shared_segment->header.generation, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void shm_write_end(void) {
+    __atomic_add_fetch(&shared_segment->header.generation, 1, __ATOMIC_RELEASE);
+}
+
+void shm_read(SharedState *out) {
+    const uint32_t *gen = &shared_segment->header.generation;
+    // A referee killed mid-update leaves the count odd forever; after this
+    // many tries the last copy is returned as it is
+    for (int tries = 0; tries < SHM_READ_MAX_TRIES; tries++) {
+        uint32_t before = __atomic_load_n(gen, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            sched_yield();  // Referee is mid-update
+            continue;
+        }
+        memcpy(out, &shared_segment->state, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(gen, __ATOMIC_RELAXED) == before)
+            return;
+    }
+    memcpy(out, &shared_segment->state, sizeof(*out));
+}
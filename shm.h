@@ -0,0 +1,56 @@
+// shm.h
+#ifndef SHM_H
+#define SHM_H
+
+#include <stdint.h>
+#include "state.h"      // SharedState layout
+
+// ----------------------------------------------------------
+// The segment that holds SharedState. It is either anonymous (only
+// forked children see it) or a named POSIX shared-memory object that any
+// process may attach to read-only with shm_attach().
+//
+// The header identifies the layout, and `generation` is a sequence lock:
+// the referee makes it odd while it updates the state and even again
+// afterwards, so readers can take a consistent copy without any lock or
+// help from the referee.
+// ----------------------------------------------------------
+
+#define SHM_MAGIC "TUGSHM\0\0"
+#define SHM_LAYOUT_VERSION 2
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t layout_size;       // sizeof(SharedSegment)
+    uint32_t generation;        // Odd while the referee is writing
+    int32_t  writer_pid;
+} SharedHeader;
+
+typedef struct {
+    SharedHeader header;
+    SharedState  state;
+} SharedSegment;
+
+extern SharedSegment *shared_segment;
+
+// Map a fresh, zeroed segment (name NULL: anonymous) and point
+// shared_state at it. A named segment is removed again by shm_release.
+// Fails if the name is taken by a running referee; a segment left behind
+// by one that died is replaced.
+int  shm_create(const char *name);
+
+// Map an existing named segment read-only and check its header
+int  shm_attach(const char *name);
+
+// Unmap the segment (and unlink it if this process created it by name)
+void shm_release(void);
+
+// Bracket every update of shared_state by the referee
+void shm_write_begin(void);
+void shm_write_end(void);
+
+// Copy a consistent snapshot of the state
+void shm_read(SharedState *out);
+
+#endif  // SHM_H
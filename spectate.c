@@ -0,0 +1,112 @@
+/*
+ * tug_spectate: terminal client for the referee's spectator socket.
+ * Usage: tug_spectate SOCKET
+ * Applies the delta frames to a local copy of the shared state and prints
+ * one status line per update until the match ends.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "spectator.h"
+#include "state.h"      // SharedState layout
+
+// Read exactly len bytes; returns -1 on EOF or error
+static int read_full(int fd, void *buf, size_t len) {
+    unsigned char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Apply one frame payload to *st; returns -1 if it is malformed
+static int apply_frame(SharedState *st, const unsigned char *p, size_t len) {
+    uint32_t *words = (uint32_t *)st;
+    size_t nwords = sizeof(*st) / sizeof(uint32_t);
+    while (len > 0) {
+        uint16_t run[2];
+        if (len < sizeof(run))
+            return -1;
+        memcpy(run, p, sizeof(run));
+        p += sizeof(run);
+        len -= sizeof(run);
+        size_t bytes = (size_t)run[1] * sizeof(uint32_t);
+        if ((size_t)run[0] + run[1] > nwords || bytes > len)
+            return -1;
+        memcpy(&words[run[0]], p, bytes);
+        p += bytes;
+        len -= bytes;
+    }
+    return 0;
+}
+
+static void print_state(const SharedState *st, uint32_t generation) {
+    printf("[%6u] %4ds  round %-3d  wins %d-%d  rope %7.2f/%.0f  effort %8.1f vs %-8.1f",
+           generation, st->elapsed_seconds, st->round_number,
+           st->team_round_wins[0], st->team_round_wins[1],
+           st->rope_position, st->rope_threshold,
+           st->team_efforts[0], st->team_efforts[1]);
+    if (st->whatif_branches > 0)
+        printf("  P(win) %.0f%%/%.0f%%",
+               st->win_probability[0] * 100.0f, st->win_probability[1] * 100.0f);
+    printf("\n");
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s SOCKET\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", argv[1]);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    SpectatorHello hello;
+    if (read_full(fd, &hello, sizeof(hello)) != 0 ||
+        memcmp(hello.magic, SPECTATOR_MAGIC, sizeof(hello.magic)) != 0 ||
+        hello.version != SPECTATOR_VERSION || hello.state_size != sizeof(SharedState)) {
+        fprintf(stderr, "%s: not a compatible spectator stream\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    SharedState st;
+    memset(&st, 0, sizeof(st));
+    unsigned char *payload = malloc(2 * sizeof(SharedState) + 64);
+    for (;;) {
+        uint32_t header[2];  // Payload bytes, generation
+        if (read_full(fd, header, sizeof(header)) != 0)
+            break;
+        if (header[0] > 2 * sizeof(SharedState) + 64 ||
+            read_full(fd, payload, header[0]) != 0 ||
+            apply_frame(&st, payload, header[0]) != 0) {
+            fprintf(stderr, "Malformed frame\n");
+            break;
+        }
+        print_state(&st, header[1]);
+        if (st.game_ended) {
+            printf("=== Match over: Team %d wins ===\n", st.final_winner + 1);
+            break;
+        }
+    }
+    free(payload);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,274 @@
+// UNIX-socket spectator server (see spectator.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "spectator.h"
+#include "shm.h"
+#include "log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// How often the server looks for a new generation
+#define SPECTATOR_POLL_MSEC 10
+
+#define STATE_WORDS (sizeof(SharedState) / sizeof(uint32_t))
+
+// Worst case frame: 8-byte header, one run header per word, every word
+#define FRAME_MAX (8 + STATE_WORDS * (sizeof(uint32_t) + 2 * sizeof(uint16_t)))
+
+typedef struct {
+    int         fd;
+    SharedState sent;           // State the client has once `out` is delivered
+    size_t      out_len;
+    size_t      out_pos;
+    unsigned char out[FRAME_MAX];
+} Client;
+
+static int listen_fd = -1;
+static char socket_path[108];
+static pthread_t server;
+static volatile int server_stop = 0;
+static int server_running = 0;
+static Client *clients[SPECTATOR_MAX_CLIENTS];
+
+// ---------------------------------------------------------------------
+// Encoding
+// ---------------------------------------------------------------------
+
+// Build the frame that takes c->sent to *now; returns 0 if nothing changed
+static int encode_delta(Client *c, const SharedState *now, uint32_t generation) {
+    const uint32_t *old_w = (const uint32_t *)&c->sent;
+    const uint32_t *new_w = (const uint32_t *)now;
+    unsigned char *p = c->out + 8;
+
+    for (size_t w = 0; w < STATE_WORDS; ) {
+        if (old_w[w] == new_w[w]) {
+            w++;
+            continue;
+        }
+        size_t first = w;
+        while (w < STATE_WORDS && old_w[w] != new_w[w])
+            w++;
+        uint16_t run[2] = { (uint16_t)first, (uint16_t)(w - first) };
+        memcpy(p, run, sizeof(run));
+        p += sizeof(run);
+        memcpy(p, &new_w[first], (w - first) * sizeof(uint32_t));
+        p += (w - first) * sizeof(uint32_t);
+    }
+
+    uint32_t payload = (uint32_t)(p - c->out - 8);
+    if (payload == 0)
+        return 0;
+    memcpy(c->out, &payload, sizeof(payload));
+    memcpy(c->out + 4, &generation, sizeof(generation));
+    c->out_len = (size_t)(p - c->out);
+    c->out_pos = 0;
+    c->sent = *now;
+    return 1;
+}
+
+// ---------------------------------------------------------------------
+// Clients
+// ---------------------------------------------------------------------
+static void drop_client(int i) {
+    close(clients[i]->fd);
+    free(clients[i]);
+    clients[i] = NULL;
+}
+
+static void accept_clients(void) {
+    for (;;) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        int slot = -1;
+        for (int i = 0; i < SPECTATOR_MAX_CLIENTS && slot < 0; i++) {
+            if (!clients[i])
+                slot = i;
+        }
+        Client *c = slot >= 0 ? calloc(1, sizeof(Client)) : NULL;
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+
+        // The hello goes first; the first frame then carries the full state
+        SpectatorHello hello;
+        memcpy(hello.magic, SPECTATOR_MAGIC, sizeof(hello.magic));
+        hello.version = SPECTATOR_VERSION;
+        hello.state_size = sizeof(SharedState);
+        memcpy(c->out, &hello, sizeof(hello));
+        c->out_len = sizeof(hello);
+        clients[slot] = c;
+    }
+}
+
+// Write as much of the pending frame as the socket takes; -1 on error
+static int flush_client(Client *c) {
+    while (c->out_pos < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_pos, c->out_len - c->out_pos,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        c->out_pos += (size_t)n;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Server thread
+// ---------------------------------------------------------------------
+static void *server_main(void *arg) {
+    (void)arg;
+    SharedState now;
+    memset(&now, 0, sizeof(now));
+    uint32_t last_generation = 1;   // Odd: never a published generation
+
+    while (!server_stop) {
+        struct pollfd fds[1 + SPECTATOR_MAX_CLIENTS];
+        int map[1 + SPECTATOR_MAX_CLIENTS];
+        int nfds = 0;
+        fds[nfds].fd = listen_fd;
+        fds[nfds].events = POLLIN;
+        map[nfds++] = -1;
+        for (int i = 0; i < SPECTATOR_MAX_CLIENTS; i++) {
+            if (!clients[i])
+                continue;
+            fds[nfds].fd = clients[i]->fd;
+            fds[nfds].events = clients[i]->out_pos < clients[i]->out_len ? POLLOUT : 0;
+            map[nfds++] = i;
+        }
+        poll(fds, (nfds_t)nfds, SPECTATOR_POLL_MSEC);
+
+        if (fds[0].revents & POLLIN)
+            accept_clients();
+        for (int k = 1; k < nfds; k++) {
+            if (fds[k].revents & (POLLERR | POLLHUP))
+                drop_client(map[k]);
+        }
+
+        // New state: queue a delta for every client that is not still busy
+        // with an earlier frame; busy clients catch up once they drain
+        uint32_t generation = __atomic_load_n(&shared_segment->header.generation,
+                                              __ATOMIC_ACQUIRE);
+        int changed = generation != last_generation;
+        if (changed)
+            shm_read(&now);
+        for (int i = 0; i < SPECTATOR_MAX_CLIENTS; i++) {
+            Client *c = clients[i];
+            if (!c)
+                continue;
+            if (flush_client(c) != 0) {
+                drop_client(i);
+                continue;
+            }
+            if (c->out_pos == c->out_len &&
+                encode_delta(c, &now, generation) && flush_client(c) != 0)
+                drop_client(i);
+        }
+        last_generation = generation;
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------
+
+// Clear the way for bind: only a socket left over from an earlier run is
+// removed, never a file or the socket of a referee still listening on it
+static int remove_stale_socket(const struct sockaddr_un *addr) {
+    const char *path = addr->sun_path;
+    struct stat st;
+    if (lstat(path, &st) != 0) {
+        if (errno == ENOENT)
+            return 0;
+        perror(path);
+        return -1;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        fprintf(stderr, "%s exists and is not a socket\n", path);
+        return -1;
+    }
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe >= 0) {
+        int live = connect(probe, (const struct sockaddr *)addr, sizeof(*addr)) == 0;
+        close(probe);
+        if (live) {
+            fprintf(stderr, "%s is in use by another referee\n", path);
+            return -1;
+        }
+    }
+    if (unlink(path) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+int spectator_start(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Spectator socket path too long: %s\n", path);
+        return -1;
+    }
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("spectator socket");
+        return -1;
+    }
+    if (remove_stale_socket(&addr) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, 16) != 0) {
+        perror(path);
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+    snprintf(socket_path, sizeof(socket_path), "%s", path);
+
+    server_stop = 0;
+    if (pthread_create(&server, NULL, server_main, NULL) != 0) {
+        perror("spectator thread");
+        close(listen_fd);
+        listen_fd = -1;
+        unlink(socket_path);
+        return -1;
+    }
+    server_running = 1;
+    LOG_INFO("Spectators can connect on %s\n", socket_path);
+    return 0;
+}
+
+void spectator_stop(void) {
+    if (!server_running)
+        return;
+    server_stop = 1;
+    pthread_join(server, NULL);
+    server_running = 0;
+    for (int i = 0; i < SPECTATOR_MAX_CLIENTS; i++) {
+        if (clients[i])
+            drop_client(i);
+    }
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path);
+}
@@ -0,0 +1,41 @@
+// spectator.h
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Spectator server: a thread in the referee that streams the shared
+// state to any number of clients on a local UNIX socket. It only reads
+// the SharedState segment (through its sequence lock), so the tick loop
+// never waits for it.
+//
+// Stream format (native byte order, local use only):
+//   hello:  SpectatorHello
+//   frames: uint32 payload bytes, uint32 generation, then runs of
+//           { uint16 first word, uint16 word count, words... }
+// A run replaces 32-bit words of the client's SharedState copy, which
+// starts out zeroed. Updates are coalesced per client: a client that is
+// still busy with an earlier frame later gets one frame with everything
+// that changed since then, never a backlog.
+// ----------------------------------------------------------
+
+#define SPECTATOR_MAGIC "TUGSPEC\0"
+#define SPECTATOR_VERSION 1
+
+// Most clients served at once; later ones are turned away
+#define SPECTATOR_MAX_CLIENTS 64
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t state_size;        // sizeof(SharedState) of the referee
+} SpectatorHello;
+
+// Bind path and start the server thread; returns 0 on success
+int  spectator_start(const char *path);
+
+// Stop the thread, disconnect clients and remove the socket file
+void spectator_stop(void);
+
+#endif  // SPECTATOR_H
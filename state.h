@@ -0,0 +1,52 @@
+// state.h
+#ifndef STATE_H
+#define STATE_H
+
+#include <stdint.h>     // For int64_t
+#include <sys/types.h>  // For pid_t
+
+// ----------------------------------------------------------
+// Layouts shared by the referee and every front end (OpenGL, terminal,
+// spectators). Nothing here depends on OpenGL, so GL-free builds and
+// tools can include it.
+// ----------------------------------------------------------
+
+// Number of teams / players (must match main.c)
+#define NUM_TEAMS 2
+#define PLAYERS_PER_TEAM 4
+
+// ----------------------------------------------------------
+// One player, as kept by the referee
+// ----------------------------------------------------------
+typedef struct {
+    float energy;
+    float effort;
+    float decay_rate;
+    int   position;
+    int   active;
+    int   recovering;
+    int64_t recover_time;   // Game-clock ns when a fallen player is back up
+    pid_t pid;
+} Player;
+
+// ----------------------------------------------------------
+// The state the referee publishes for visualizers and spectators
+// ----------------------------------------------------------
+typedef struct {
+    float rope_position;             // Real-time rope displacement
+    int   team_round_wins[NUM_TEAMS];
+    Player players[NUM_TEAMS][PLAYERS_PER_TEAM];
+    int   round_number;              // Current round
+    int   game_ended;                // 0 while running, 1 once the match is done
+    int   final_winner;              // -1 if no winner yet, else 0 or 1 for which team won
+    float team_efforts[NUM_TEAMS];   // Total effort per team
+    float win_probability[NUM_TEAMS]; // What-if estimate of each team winning
+    int   whatif_branches;           // Branches behind the estimate, 0 if none yet
+    float rope_threshold;            // Rope clamp, so attached viewers need no config
+    int   elapsed_seconds;           // Game time since the match started
+    float time_warp;                 // Game seconds per real second, 0 when headless
+} SharedState;
+
+extern SharedState *shared_state;        // Shared memory
+
+#endif  // STATE_H
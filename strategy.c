@@ -0,0 +1,217 @@
+// Effort strategies (see strategy.h)
+#define _GNU_SOURCE
+#include "strategy.h"
+#include "config.h"
+#include "game.h"
+#include "game_clock.h"
+#include "arena.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <dlfcn.h>
+
+// Selected strategy per team (NULL = linear)
+static StrategyFn team_fn[NUM_TEAMS];
+static char team_spec[NUM_TEAMS][STRATEGY_NAME_MAX];
+static uint64_t team_digest[NUM_TEAMS];
+
+// Scratch arrays for one team at a time
+static float         *scratch_energy;
+static int           *scratch_position;
+static unsigned char *scratch_live;
+static float         *scratch_exertion;
+
+// ---------------------------------------------------------------------
+// Built-in strategies
+// ---------------------------------------------------------------------
+
+// Hold back while the round is undecided, then pull all out once the rope
+// is close to either threshold (to close the round out or to save it)
+static void strategy_pacing(const StrategyTeam *team, float *exertion) {
+    float urgency = fabsf(team->lead) / team->round_win_threshold;
+    float x = urgency >= 0.6f ? 1.5f : 0.7f;
+    for (int p = 0; p < team->players; p++)
+        exertion[p] = x;
+}
+
+// Players below a third of the starting energy range rest at half effort
+static void strategy_conserve(const StrategyTeam *team, float *exertion) {
+    float tired = (float)config.minimum_energy / 3.0f;
+    for (int p = 0; p < team->players; p++)
+        exertion[p] = team->energy[p] < tired ? 0.5f : 1.0f;
+}
+
+static const struct {
+    const char *name;
+    StrategyFn  fn;
+} builtins[] = {
+    { "linear",   NULL },    // energy x position, the engine default
+    { "pacing",   strategy_pacing },
+    { "conserve", strategy_conserve },
+};
+
+// ---------------------------------------------------------------------
+// Selection
+// ---------------------------------------------------------------------
+
+// FNV-1a over a file's contents; returns -1 if it cannot be read
+static int hash_file(const char *path, uint64_t *digest) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    uint64_t h = 1469598103934665603ULL;
+    unsigned char buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            h ^= buf[i];
+            h *= 1099511628211ULL;
+        }
+    }
+    int failed = ferror(f);
+    fclose(f);
+    if (failed)
+        return -1;
+    *digest = h;
+    return 0;
+}
+
+int strategy_select(int team, const char *spec, char *err, size_t err_len) {
+    if (team < 0 || team >= NUM_TEAMS) {
+        snprintf(err, err_len, "no team %d", team + 1);
+        return -1;
+    }
+    if (strlen(spec) >= STRATEGY_NAME_MAX) {
+        snprintf(err, err_len, "strategy name too long");
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++) {
+        if (strcmp(builtins[i].name, spec) == 0) {
+            team_fn[team] = builtins[i].fn;
+            team_digest[team] = 0;
+            snprintf(team_spec[team], sizeof(team_spec[team]), "%s", spec);
+            return 0;
+        }
+    }
+
+    // path[:symbol]
+    char path[STRATEGY_NAME_MAX];
+    snprintf(path, sizeof(path), "%s", spec);
+    const char *symbol = STRATEGY_DEFAULT_SYMBOL;
+    char *colon = strrchr(path, ':');
+    if (colon) {
+        *colon = '\0';
+        symbol = colon + 1;
+    }
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        snprintf(err, err_len, "%s", dlerror());
+        return -1;
+    }
+    StrategyFn fn = (StrategyFn)dlsym(handle, symbol);
+    if (!fn) {
+        snprintf(err, err_len, "%s: no symbol %s", path, symbol);
+        dlclose(handle);
+        return -1;
+    }
+    // Hash the object the symbol was found in (dlopen may have searched
+    // the library path for it)
+    Dl_info info;
+    const char *file = dladdr((void *)fn, &info) && info.dli_fname ? info.dli_fname : path;
+    uint64_t digest;
+    if (hash_file(file, &digest) != 0) {
+        snprintf(err, err_len, "%s: cannot read the shared object", file);
+        dlclose(handle);
+        return -1;
+    }
+    // The handle stays open for the life of the process
+    team_fn[team] = fn;
+    team_digest[team] = digest;
+    snprintf(team_spec[team], sizeof(team_spec[team]), "%s", spec);
+    return 0;
+}
+
+const char *strategy_name(int team) {
+    return team_spec[team][0] ? team_spec[team] : "linear";
+}
+
+uint64_t strategy_digest(int team) {
+    return team_digest[team];
+}
+
+int strategy_active(void) {
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        if (team_fn[t])
+            return 1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Tick step
+// ---------------------------------------------------------------------
+size_t strategy_scratch_size(int players) {
+    size_t n = (size_t)players;
+    return arena_block_size(n * sizeof(float))
+         + arena_block_size(n * sizeof(int))
+         + arena_block_size(n)
+         + arena_block_size(n * sizeof(float));
+}
+
+void strategy_set_scratch(void *mem, int players) {
+    char *p = mem;
+    size_t n = (size_t)players;
+    scratch_energy   = (float *)p;          p += arena_block_size(n * sizeof(float));
+    scratch_position = (int *)p;            p += arena_block_size(n * sizeof(int));
+    scratch_live     = (unsigned char *)p;  p += arena_block_size(n);
+    scratch_exertion = (float *)p;
+}
+
+void strategy_energy_reports(void) {
+    int n = config.players_per_team;
+    float elapsed = (float)game_clock_ns() / (float)NSEC_PER_SEC;
+
+    for (int t = 0; t < config.num_teams; t++) {
+        Player *row = teams[t];
+        float *exertion = scratch_exertion;
+
+        if (team_fn[t]) {
+            // Gather the team into arrays, then ask the strategy
+            for (int p = 0; p < n; p++) {
+                scratch_energy[p]   = row[p].energy;
+                scratch_position[p] = row[p].position;
+                scratch_live[p]     = (unsigned char)(row[p].active && !row[p].recovering);
+            }
+            StrategyTeam team = {
+                .team                = t,
+                .players             = n,
+                .energy              = scratch_energy,
+                .position            = scratch_position,
+                .live                = scratch_live,
+                .lead                = t == 0 ? -rope_position : rope_position,
+                .round_win_threshold = (float)config.round_win_threshold,
+                .round_number        = round_number,
+                .elapsed             = elapsed,
+            };
+            team_fn[t](&team, exertion);
+        } else {
+            for (int p = 0; p < n; p++)
+                exertion[p] = 1.0f;
+        }
+
+        // Same arithmetic as the float kernel, scaled by the exertion
+        for (int p = 0; p < n; p++) {
+            if (!row[p].active || row[p].recovering)
+                continue;
+            float x = exertion[p];
+            if (!(x >= 0.0f))
+                x = 0.0f;  // Also catches NaN from a plugin
+            if (x > STRATEGY_MAX_EXERTION)
+                x = STRATEGY_MAX_EXERTION;
+            row[p].energy -= row[p].decay_rate * tick_params.decay_per_tick_scale * x;
+            if (row[p].energy < 0)
+                row[p].energy = 0;
+            row[p].effort = row[p].energy * (float)row[p].position * x;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// strategy.h
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------
+// Effort strategies. A strategy decides how hard each player of one team
+// pulls this tick: its exertion, where 1 is the default pull, 0 is
+// resting and STRATEGY_MAX_EXERTION an all-out surge. A player's energy
+// then decays by decay_rate x exertion and its effort is
+// energy x position x exertion.
+//
+// A strategy is called once per team per tick with the whole team as
+// arrays, so it can be written as plain loops the compiler vectorizes.
+// Built-in strategies are looked up by name; anything else is taken as a
+// shared object path, optionally followed by ":symbol" (default symbol
+// STRATEGY_DEFAULT_SYMBOL), and loaded with dlopen.
+//
+// With no strategy selected (or "linear" on both sides) the engine runs
+// its tick kernel unchanged, so default matches are not affected. While
+// a strategy is active the energy step is single precision, also with
+// --kernel fixed (team sums and the rope still use the tick kernel).
+// ----------------------------------------------------------
+
+#define STRATEGY_MAX_EXERTION   2.0f
+#define STRATEGY_DEFAULT_SYMBOL "tug_strategy"
+#define STRATEGY_NAME_MAX       128
+
+// One team's state as seen by a strategy (arrays hold `players` entries)
+typedef struct {
+    int                  team;                 // 0 or 1
+    int                  players;
+    const float         *energy;               // Energy before this tick's decay
+    const int           *position;             // 1 = weakest .. players = strongest
+    const unsigned char *live;                 // 1 if active and not recovering
+    float                lead;                 // Rope displacement in this team's favour
+    float                round_win_threshold;  // |rope| that ends the round
+    int                  round_number;
+    float                elapsed;              // Game seconds since the match started
+} StrategyTeam;
+
+// Fill exertion[0..players); values are clamped to [0, STRATEGY_MAX_EXERTION]
+// and ignored for players that are not live
+typedef void (*StrategyFn)(const StrategyTeam *team, float *exertion);
+
+// Choose the strategy for one team; returns 0, or -1 with a message in err
+int  strategy_select(int team, const char *spec, char *err, size_t err_len);
+
+// Spec of a team's strategy ("linear" if none was chosen)
+const char *strategy_name(int team);
+
+// FNV-1a hash of the contents of a team's shared object, taken when it
+// was loaded (0 for built-in strategies), so cached results follow a
+// rebuilt plugin
+uint64_t strategy_digest(int team);
+
+// 1 if any team plays something other than "linear"
+int  strategy_active(void);
+
+// Per-match scratch arrays, carved by allocate_game()
+size_t strategy_scratch_size(int players);
+void   strategy_set_scratch(void *mem, int players);
+
+// Replaces request_energy_reports_partial() while a strategy is active
+void strategy_energy_reports(void);
+
+#endif  // STRATEGY_H
@@ -0,0 +1,405 @@
+/*
+ * Process-mode stress harness
+ * Starts the player process pool at growing roster sizes and measures
+ * what the fork-per-player design costs: fork time, resident memory of
+ * the referee and the players, the referee's fds (one energy pipe per
+ * player), delivery latency and losses of the round result signals sent
+ * by notify_round_result, and tick overruns of the referee loop with all
+ * players alive. It stops at the first size that cannot be started and
+ * reports why (RLIMIT_NOFILE, process limits, memory). --pin-cpu places
+ * the referee as tug_of_war --pin-cpu does, to compare tick lateness.
+ * Results are written as JSON, like tug_bench.
+ *
+ * Usage: ./tug_stress [output.json] [--start N] [--max-players N]
+ *                    [--ticks N] [--warp X] [--rounds N] [--nofile N]
+ *                    [--pin-cpu N]
+ */
+
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/resource.h>
+#include "config.h"
+#include "game.h"
+#include "game_clock.h"
+#include "log.h"
+#include "player_pool.h"
+#include "realtime.h"
+#include "shm.h"
+
+// Roster sizes (players per team) double from --start up to --max-players
+#define STRESS_START_PLAYERS 64
+#define STRESS_MAX_PLAYERS   2048
+
+// How long a player may take to handle a round result signal before it
+// counts as lost
+#define STRESS_SIGNAL_TIMEOUT_NSEC 1000000000LL
+// Pause between two measured notifications, so they do not coalesce
+#define STRESS_SIGNAL_GAP_NSEC     2000000L
+// Notifications sent back to back to count coalesced (lost) signals
+#define STRESS_BURST               8
+
+static FILE *json = NULL;
+static int   first_entry = 1;
+
+// ---------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------
+static int64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static void sleep_ns(long ns) {
+    struct timespec ts = { ns / NSEC_PER_SEC, ns % NSEC_PER_SEC };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR)
+        ;
+}
+
+static int count_fds(void) {
+    DIR *dir = opendir("/proc/self/fd");
+    if (!dir)
+        return -1;
+    int n = 0;
+    struct dirent *e;
+    while ((e = readdir(dir)) != NULL) {
+        if (e->d_name[0] != '.')
+            n++;
+    }
+    closedir(dir);
+    return n - 1;  // The directory stream itself
+}
+
+// Resident and proportional set size of a process in kB (Pss splits
+// copy-on-write pages among the processes sharing them)
+static void process_memory(pid_t pid, long *rss_kb, long *pss_kb) {
+    char path[64], line[128];
+    *rss_kb = *pss_kb = 0;
+    snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return;
+    while (fgets(line, sizeof(line), f)) {
+        sscanf(line, "Rss: %ld", rss_kb);
+        sscanf(line, "Pss: %ld", pss_kb);
+    }
+    fclose(f);
+}
+
+static long read_long_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    long v = -1;
+    if (f) {
+        if (fscanf(f, "%ld", &v) != 1)
+            v = -1;
+        fclose(f);
+    }
+    return v;
+}
+
+static int compare_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(int64_t *v, int n, double q) {
+    if (n == 0)
+        return 0.0;
+    int i = (int)(q * (n - 1) + 0.5);
+    return (double)v[i] / 1e3;
+}
+
+static void json_entry_start(void) {
+    fprintf(json, first_entry ? "\n    " : ",\n    ");
+    first_entry = 0;
+}
+
+// ---------------------------------------------------------------------
+// Measurements at one roster size
+// ---------------------------------------------------------------------
+
+// Send `rounds` notifications one at a time and time each player's
+// handler; then a burst of STRESS_BURST back to back to count signals
+// the kernel merged (standard signals do not queue)
+static void measure_signals(int nplayers, int rounds, double *notify_us,
+                            double lat_us[3], long *lost, long *coalesced) {
+    int64_t *lat = malloc((size_t)nplayers * (size_t)rounds * sizeof(int64_t));
+    uint32_t *seen = malloc((size_t)nplayers * sizeof(uint32_t));
+    int nlat = 0;
+    int64_t notify_total = 0;
+    *lost = 0;
+    *coalesced = 0;
+    if (!lat || !seen) {
+        free(lat);
+        free(seen);
+        return;
+    }
+
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < nplayers; i++)
+            seen[i] = player_pool_probe(i)->count;
+        int64_t t0 = mono_ns();
+        notify_round_result(r % NUM_TEAMS);
+        notify_total += mono_ns() - t0;
+
+        // Wait for every handler (or the timeout)
+        int pending = nplayers;
+        while (pending > 0 && mono_ns() - t0 < STRESS_SIGNAL_TIMEOUT_NSEC) {
+            pending = 0;
+            for (int i = 0; i < nplayers; i++) {
+                if (__atomic_load_n(&player_pool_probe(i)->count, __ATOMIC_ACQUIRE) == seen[i])
+                    pending++;
+            }
+            if (pending > 0)
+                sleep_ns(50000);
+        }
+        for (int i = 0; i < nplayers; i++) {
+            const volatile PlayerProbe *probe = player_pool_probe(i);
+            if (probe->count != seen[i])
+                lat[nlat++] = probe->last_ns - t0;
+        }
+        *lost += pending;
+        sleep_ns(STRESS_SIGNAL_GAP_NSEC);
+    }
+
+    // Burst: a player handles between 1 and STRESS_BURST of these
+    for (int i = 0; i < nplayers; i++)
+        seen[i] = player_pool_probe(i)->count;
+    for (int b = 0; b < STRESS_BURST; b++)
+        notify_round_result(0);
+    sleep_ns(STRESS_SIGNAL_TIMEOUT_NSEC / 4);
+    for (int i = 0; i < nplayers; i++)
+        *coalesced += STRESS_BURST - (long)(player_pool_probe(i)->count - seen[i]);
+
+    qsort(lat, (size_t)nlat, sizeof(int64_t), compare_i64);
+    *notify_us = (double)notify_total / rounds / 1e3;
+    lat_us[0] = percentile_us(lat, nlat, 0.5);
+    lat_us[1] = percentile_us(lat, nlat, 0.99);
+    lat_us[2] = percentile_us(lat, nlat, 1.0);
+    free(lat);
+    free(seen);
+}
+
+// Run the per-tick steps on the live game clock (warped) and count ticks
+// whose work overran the tick, and how late the referee woke up
+static void measure_ticks(int ticks, double warp, int *overruns, double late_us[2]) {
+    int64_t *late = malloc((size_t)ticks * sizeof(int64_t));
+    *overruns = 0;
+    if (!late)
+        return;
+    game_clock_set_warp(warp);
+    game_clock_start(0);
+    for (int i = 0; i < ticks; i++) {
+        check_player_falls_partial();
+        recover_players_partial();
+        request_energy_reports_partial();
+        update_rope_position_partial();
+        mirror_to_shared_memory();
+
+        int64_t deadline = (int64_t)(i + 1) * TICK_NSEC;
+        if (game_clock_ns() > deadline)
+            (*overruns)++;
+        game_clock_sleep_until(deadline);
+        // Lateness in real time (the game clock runs warp times faster)
+        late[i] = (int64_t)((double)(game_clock_ns() - deadline) / warp);
+    }
+    qsort(late, (size_t)ticks, sizeof(int64_t), compare_i64);
+    late_us[0] = percentile_us(late, ticks, 0.99);
+    late_us[1] = percentile_us(late, ticks, 1.0);
+    free(late);
+}
+
+// Why starting the pool failed, from the errno of pipe() or fork()
+static const char *break_reason(int err) {
+    switch (err) {
+        case EMFILE: return "RLIMIT_NOFILE (per-process open files)";
+        case ENFILE: return "system-wide open file limit";
+        case EAGAIN: return "process limit (RLIMIT_NPROC, pid_max or threads-max)";
+        case ENOMEM: return "out of memory";
+        default:     return strerror(err);
+    }
+}
+
+// Returns 0 if the size ran, -1 (with the reason recorded) if not
+static int run_size(int players, int ticks, double warp, int rounds) {
+    int nplayers = NUM_TEAMS * players;
+    config.players_per_team = players;
+    reset_match_state();
+    derive_tick_params();
+    game_srand(1);
+    initialize_game();
+
+    int fds_before = count_fds();
+    int64_t t0 = mono_ns();
+    if (player_pool_start(nplayers) != 0) {
+        int err = errno;
+        json_entry_start();
+        fprintf(json, "{\"players_per_team\": %d, \"processes\": %d, \"started\": false, "
+                      "\"errno\": %d, \"reason\": \"%s\"}",
+                players, nplayers, err, break_reason(err));
+        fprintf(stderr, "%8d %8d  failed: %s (%s)\n",
+                players, nplayers, break_reason(err), strerror(err));
+        free_game();
+        return -1;
+    }
+    double fork_ms = (double)(mono_ns() - t0) / 1e6;
+    int fds_after = count_fds();
+
+    // Reset them for a match, as the referee does
+    t0 = mono_ns();
+    start_players();
+    double reset_ms = (double)(mono_ns() - t0) / 1e6;
+
+    long ref_rss, ref_pss, rss, pss, players_rss = 0, players_pss = 0;
+    process_memory(getpid(), &ref_rss, &ref_pss);
+    for (int i = 0; i < nplayers; i++) {
+        process_memory(player_pool_pid(i), &rss, &pss);
+        players_rss += rss;
+        players_pss += pss;
+    }
+
+    double notify_us = 0.0, lat_us[3] = {0.0, 0.0, 0.0};
+    long lost, coalesced;
+    measure_signals(nplayers, rounds, &notify_us, lat_us, &lost, &coalesced);
+
+    int overruns;
+    double late_us[2] = {0.0, 0.0};
+    measure_ticks(ticks, warp, &overruns, late_us);
+
+    player_pool_stop();
+    free_game();
+
+    json_entry_start();
+    fprintf(json, "{\"players_per_team\": %d, \"processes\": %d, \"started\": true, "
+                  "\"fork_ms\": %.2f, \"fork_us_per_process\": %.1f, \"reset_ms\": %.2f, "
+                  "\"referee_rss_kb\": %ld, \"players_rss_kb\": %ld, \"players_pss_kb\": %ld, "
+                  "\"referee_fds\": %d, \"pipe_fds\": %d, "
+                  "\"notify_us\": %.1f, \"signal_p50_us\": %.1f, \"signal_p99_us\": %.1f, "
+                  "\"signal_max_us\": %.1f, \"signals_lost\": %ld, \"signals_coalesced\": %ld, "
+                  "\"ticks\": %d, \"tick_overruns\": %d, \"tick_late_p99_us\": %.1f, "
+                  "\"tick_late_max_us\": %.1f}",
+            players, nplayers, fork_ms, fork_ms * 1e3 / nplayers, reset_ms,
+            ref_rss, players_rss, players_pss, fds_after, fds_after - fds_before,
+            notify_us, lat_us[0], lat_us[1], lat_us[2], lost, coalesced,
+            ticks, overruns, late_us[0], late_us[1]);
+    fprintf(stderr, "%8d %8d %9.1f %9.1f %9ld %6d %9.1f %9.1f %9.1f %6ld %6ld %6d %9.1f\n",
+            players, nplayers, fork_ms, reset_ms, players_pss / 1024, fds_after,
+            notify_us, lat_us[1], lat_us[2], lost, coalesced, overruns, late_us[1]);
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    const char *out_path = "stress_results.json";
+    int start = STRESS_START_PLAYERS;
+    int max_players = STRESS_MAX_PLAYERS;
+    int ticks = 100;
+    double warp = 10.0;
+    int rounds = 20;
+    long nofile = 0;
+    int pin_cpu = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--start") == 0 && i + 1 < argc) {
+            start = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-players") == 0 && i + 1 < argc) {
+            max_players = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warp") == 0 && i + 1 < argc) {
+            warp = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--nofile") == 0 && i + 1 < argc) {
+            nofile = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--pin-cpu") == 0 && i + 1 < argc) {
+            pin_cpu = atoi(argv[++i]);
+        } else {
+            out_path = argv[i];
+        }
+    }
+    if (start < 1 || max_players < start || ticks < 1 || rounds < 1 ||
+        warp < GAME_CLOCK_WARP_MIN || warp > GAME_CLOCK_WARP_MAX) {
+        fprintf(stderr, "Bad arguments\n");
+        return EXIT_FAILURE;
+    }
+
+    // --nofile lowers the open file limit to find where the pipes break
+    struct rlimit lim;
+    if (nofile > 0 && getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = (rlim_t)nofile;
+        if (setrlimit(RLIMIT_NOFILE, &lim) != 0)
+            perror("setrlimit RLIMIT_NOFILE");
+    }
+
+    json = fopen(out_path, "w");
+    if (!json) {
+        perror("Error opening stress output");
+        return EXIT_FAILURE;
+    }
+    if (map_shared_state() != 0)
+        return EXIT_FAILURE;
+    log_set_level(LOG_LEVEL_WARN);
+    headless = 0;  // Live clock and real player processes
+    player_pool_enable_probe(1);
+
+    // Players forked from now on are kept off the referee's core
+    if (pin_cpu >= 0) {
+        if (realtime_enter(pin_cpu) != 0)
+            return EXIT_FAILURE;
+        realtime_prefault(shared_segment, sizeof(SharedSegment));
+    }
+
+    // The limits that decide where process mode breaks
+    struct rlimit nofile_lim, nproc_lim;
+    getrlimit(RLIMIT_NOFILE, &nofile_lim);
+    getrlimit(RLIMIT_NPROC, &nproc_lim);
+    long pid_max = read_long_file("/proc/sys/kernel/pid_max");
+    long threads_max = read_long_file("/proc/sys/kernel/threads-max");
+    int base_fds = count_fds();
+    long nofile_cur = nofile_lim.rlim_cur == RLIM_INFINITY ? -1 : (long)nofile_lim.rlim_cur;
+    long nproc_cur = nproc_lim.rlim_cur == RLIM_INFINITY ? -1 : (long)nproc_lim.rlim_cur;
+    // Each player costs the referee one fd (plus two while it is forked)
+    long fd_bound = nofile_cur < 0 ? -1 : (nofile_cur - base_fds - 2) / NUM_TEAMS;
+
+    fprintf(json, "{\n  \"suite\": \"tug_stress\",\n");
+    fprintf(json, "  \"timestamp\": %ld,\n", (long)time(NULL));
+    fprintf(json, "  \"limits\": {\"rlimit_nofile\": %ld, \"rlimit_nproc\": %ld, "
+                  "\"pid_max\": %ld, \"threads_max\": %ld, \"base_fds\": %d, "
+                  "\"max_players_per_team_by_fds\": %ld},\n",
+            nofile_cur, nproc_cur, pid_max, threads_max, base_fds, fd_bound);
+    fprintf(json, "  \"ticks\": %d, \"warp\": %.2f, \"signal_rounds\": %d, \"pin_cpu\": %d,\n",
+            ticks, warp, rounds, pin_cpu);
+    fprintf(json, "  \"results\": [");
+
+    fprintf(stderr, "Limits: RLIMIT_NOFILE %ld (about %ld players/team), RLIMIT_NPROC %ld, "
+                    "pid_max %ld, threads-max %ld\n",
+            nofile_cur, fd_bound, nproc_cur, pid_max, threads_max);
+    fprintf(stderr, "%8s %8s %9s %9s %9s %6s %9s %9s %9s %6s %6s %6s %9s\n",
+            "players", "procs", "fork_ms", "reset_ms", "pss_mb", "fds",
+            "notify_us", "sig_p99", "sig_max", "lost", "merged", "overr", "late_max");
+
+    int last_ok = 0;
+    for (int players = start; players <= max_players; players *= 2) {
+        if (run_size(players, ticks, warp, rounds) != 0)
+            break;
+        last_ok = players;
+    }
+
+    fprintf(json, "\n  ],\n  \"largest_players_per_team\": %d\n}\n", last_ok);
+    fclose(json);
+    fprintf(stderr, "Largest roster started: %d players per team. Results written to %s\n",
+            last_ok, out_path);
+    return 0;
+}
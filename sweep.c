@@ -0,0 +1,486 @@
+/*
+ * Parameter sweep over GameConfig fields.
+ * Expands one or more axes into a grid, plays headless matches at every
+ * grid point on the fork-based worker pool and writes a CSV table with
+ * win counts and match-length statistics per point. In adaptive mode
+ * each point gets batches of matches until its win probability is known
+ * precisely enough (see sweep_set_target_width).
+ */
+#include "sweep.h"
+#include "game.h"
+#include "log.h"
+#include "pool.h"
+#include "cache.h"
+#include "export.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+// Matches handed to a worker at a time (keeps all cores busy even
+// when the grid has fewer points than there are workers)
+#define SWEEP_MATCHES_PER_JOB 32
+
+// Adaptive mode: first batch per point, confidence level (z of a 95%
+// interval) and the error rates of the sequential test
+#define SWEEP_FIRST_BATCH  64
+#define SWEEP_Z            1.96
+#define SWEEP_SPRT_ALPHA   0.05
+#define SWEEP_SPRT_BETA    0.05
+
+// Per-job tallies; summed per grid point after the pool finishes
+typedef struct {
+    int    matches;
+    int    wins[NUM_TEAMS];
+    int    ties;
+    long   ticks;
+    long   rounds;
+    double abs_rope;
+    int    cached;              // Matches answered from the result cache
+} SweepTally;
+
+// One job: matches [first, first + count) of a grid point
+typedef struct {
+    int point;
+    int first;
+    int count;
+} SweepSlice;
+
+// Why an adaptive point stopped sampling
+enum {
+    STOP_NONE = 0,
+    STOP_WIDTH,                 // Interval reached the target width
+    STOP_SPRT,                  // Sequential test decided the favourite
+    STOP_MAX                    // Hit the matches cap
+};
+static const char *stop_names[] = { "", "width", "sprt", "max" };
+
+typedef struct {
+    const SweepAxis *axes;
+    int              naxes;
+    const SweepSlice *slices;     // Jobs of the current pool run
+    unsigned int     base_seed;
+    GameConfig       base;        // Config the axes are applied on top of
+    const char      *valid;       // Per point: 1 if the config validates
+} SweepContext;
+
+static const char *export_dir = NULL;
+static double target_width = 0.0;   // 0: fixed number of matches
+static int    sprt_enabled = 1;
+
+void sweep_set_export_dir(const char *dir) {
+    export_dir = dir;
+}
+
+void sweep_set_target_width(double width, int sequential) {
+    target_width = width;
+    sprt_enabled = sequential;
+}
+
+// ---------------------------------------------------------------------
+// Axis parsing
+// ---------------------------------------------------------------------
+int sweep_parse_axis(const char *spec, SweepAxis *axis, char *err, size_t err_len) {
+    const char *eq = strchr(spec, '=');
+    if (!eq) {
+        snprintf(err, err_len, "sweep '%s': expected field=values", spec);
+        return -1;
+    }
+    char name[64];
+    size_t name_len = (size_t)(eq - spec);
+    if (name_len >= sizeof(name))
+        name_len = sizeof(name) - 1;
+    memcpy(name, spec, name_len);
+    name[name_len] = '\0';
+
+    axis->field = config_find_field(name);
+    if (!axis->field) {
+        snprintf(err, err_len, "sweep: unknown config field '%s'", name);
+        return -1;
+    }
+
+    const char *vals = eq + 1;
+    double start, stop, step;
+    axis->count = 0;
+    if (sscanf(vals, "%lf:%lf:%lf", &start, &stop, &step) == 3) {
+        // Range: start, start+step, ... up to and including stop
+        if (step <= 0 || stop < start) {
+            snprintf(err, err_len, "sweep '%s': need step > 0 and stop >= start", spec);
+            return -1;
+        }
+        int n = (int)floor((stop - start) / step + 1e-9) + 1;
+        if (n > SWEEP_MAX_AXIS_VALUES) {
+            snprintf(err, err_len, "sweep '%s': more than %d values", spec, SWEEP_MAX_AXIS_VALUES);
+            return -1;
+        }
+        for (int i = 0; i < n; i++)
+            axis->values[axis->count++] = start + step * i;
+    } else {
+        // List: v1,v2,...
+        const char *p = vals;
+        while (*p) {
+            char *end;
+            double v = strtod(p, &end);
+            if (end == p || (*end != ',' && *end != '\0') ||
+                axis->count >= SWEEP_MAX_AXIS_VALUES) {
+                snprintf(err, err_len, "sweep '%s': bad value list", spec);
+                return -1;
+            }
+            axis->values[axis->count++] = v;
+            p = *end == ',' ? end + 1 : end;
+        }
+    }
+    if (axis->count == 0) {
+        snprintf(err, err_len, "sweep '%s': no values", spec);
+        return -1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Grid helpers
+// ---------------------------------------------------------------------
+
+// Write the config for grid point `point` (first axis varies slowest)
+static void apply_point(const SweepContext *ctx, int point, GameConfig *cfg) {
+    *cfg = ctx->base;
+    for (int a = ctx->naxes - 1; a >= 0; a--) {
+        const SweepAxis *axis = &ctx->axes[a];
+        config_set_field(cfg, axis->field, axis->values[point % axis->count]);
+        point /= axis->count;
+    }
+}
+
+// Runs in a pool worker: one slice of matches at one grid point
+static void sweep_job(int job, void *out, void *arg) {
+    const SweepContext *ctx = arg;
+    SweepTally *tally = out;
+    const SweepSlice *slice = &ctx->slices[job];
+    int point = slice->point;
+    int chunk = slice->first / SWEEP_MATCHES_PER_JOB;
+
+    memset(tally, 0, sizeof(*tally));
+    if (!ctx->valid[point])
+        return;
+
+    // Workers each need their own shared block (the parent has none)
+    if (!shared_state && map_shared_state() != 0)
+        exit(EXIT_FAILURE);
+    apply_point(ctx, point, &config);
+
+    // Only simulate the seeds the cache has not seen for this config
+    // (exports need every tick, so then the cache only records results)
+    CachePoint cache;
+    int use_cache = cache_enabled() && cache_open(&config, &cache) == 0;
+    if (export_dir) {
+        char path[600];
+        snprintf(path, sizeof(path), "%s/point%d_part%d.tugcol", export_dir, point, chunk);
+        if (export_open(path) != 0)
+            exit(EXIT_FAILURE);
+    }
+
+    for (int m = slice->first; m < slice->first + slice->count; m++) {
+        unsigned int seed = ctx->base_seed + (unsigned int)m;
+        MatchResult r;
+        if (use_cache && !export_dir && cache_lookup(&cache, seed, &r)) {
+            tally->cached++;
+        } else {
+            run_headless_match(seed, &r);
+            if (use_cache)
+                cache_store(&cache, seed, &r);
+        }
+        tally->matches++;
+        if (r.winner < 0)
+            tally->ties++;
+        else
+            tally->wins[r.winner]++;
+        tally->ticks += r.ticks;
+        tally->rounds += r.rounds_played;
+        tally->abs_rope += fabs(r.final_rope_position);
+    }
+    if (use_cache)
+        cache_close(&cache);
+    if (export_dir && export_close() != 0)
+        exit(EXIT_FAILURE);
+}
+
+// ---------------------------------------------------------------------
+// Adaptive stopping
+// ---------------------------------------------------------------------
+
+static void tally_add(SweepTally *sum, const SweepTally *t) {
+    sum->matches += t->matches;
+    sum->wins[0] += t->wins[0];
+    sum->wins[1] += t->wins[1];
+    sum->ties += t->ties;
+    sum->ticks += t->ticks;
+    sum->rounds += t->rounds;
+    sum->abs_rope += t->abs_rope;
+    sum->cached += t->cached;
+}
+
+// Team 1's win probability (a tie counts half) and its Wilson score
+// interval at SWEEP_Z
+static double win_probability(const SweepTally *t, double *low, double *high) {
+    if (t->matches == 0) {
+        *low = 0.0;
+        *high = 1.0;
+        return 0.5;
+    }
+    double n = (double)t->matches;
+    double p = (t->wins[0] + 0.5 * t->ties) / n;
+    double z2 = SWEEP_Z * SWEEP_Z;
+    double denom = 1.0 + z2 / n;
+    double centre = (p + z2 / (2.0 * n)) / denom;
+    double half = SWEEP_Z * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denom;
+    *low = centre - half > 0.0 ? centre - half : 0.0;
+    *high = centre + half < 1.0 ? centre + half : 1.0;
+    return p;
+}
+
+// Wald's sequential probability ratio test of p = 0.5 - d against
+// p = 0.5 + d, d half the target width. Once it decides, the favourite
+// is known and a narrower interval is not worth the matches.
+static int sprt_decided(const SweepTally *t) {
+    double d = 0.5 * target_width;
+    double llr = log((0.5 + d) / (0.5 - d)) * (t->wins[0] - t->wins[1]);  // Ties add 0
+    return llr >= log((1.0 - SWEEP_SPRT_BETA) / SWEEP_SPRT_ALPHA) ||
+           llr <= log(SWEEP_SPRT_BETA / (1.0 - SWEEP_SPRT_ALPHA));
+}
+
+static int stop_rule(const SweepTally *t, int max_matches) {
+    double low, high;
+    win_probability(t, &low, &high);
+    if (high - low <= target_width)
+        return STOP_WIDTH;
+    if (sprt_enabled && sprt_decided(t))
+        return STOP_SPRT;
+    if (t->matches >= max_matches)
+        return STOP_MAX;
+    return STOP_NONE;
+}
+
+// Size of a point's next batch: what the estimate so far says the target
+// width needs, in whole jobs, at most doubling the matches played
+static int next_batch(const SweepTally *t, int max_matches) {
+    if (t->matches == 0)
+        return SWEEP_FIRST_BATCH < max_matches ? SWEEP_FIRST_BATCH : max_matches;
+    double low, high;
+    double p = win_probability(t, &low, &high);
+    double z2 = SWEEP_Z * SWEEP_Z;
+    double needed = 4.0 * z2 * p * (1.0 - p) / (target_width * target_width)
+                  + z2 / target_width;   // Keeps p near 0 or 1 from asking for nothing
+    int batch = (int)ceil(needed) - t->matches;
+    if (batch > t->matches)
+        batch = t->matches;
+    batch = (batch + SWEEP_MATCHES_PER_JOB - 1) / SWEEP_MATCHES_PER_JOB * SWEEP_MATCHES_PER_JOB;
+    if (batch < SWEEP_MATCHES_PER_JOB)
+        batch = SWEEP_MATCHES_PER_JOB;
+    if (batch > max_matches - t->matches)
+        batch = max_matches - t->matches;
+    return batch;
+}
+
+// ---------------------------------------------------------------------
+// Job lists
+// ---------------------------------------------------------------------
+
+// Append jobs for matches [first, first + count) of point, one per
+// SWEEP_MATCHES_PER_JOB; returns -1 if out of memory
+static int add_slices(SweepSlice **slices, int *n, int *capacity,
+                      int point, int first, int count) {
+    for (int m = first; m < first + count; m += SWEEP_MATCHES_PER_JOB) {
+        if (*n == *capacity) {
+            int grown_capacity = *capacity ? 2 * *capacity : 256;
+            SweepSlice *grown = realloc(*slices, (size_t)grown_capacity * sizeof(SweepSlice));
+            if (!grown)
+                return -1;
+            *slices = grown;
+            *capacity = grown_capacity;
+        }
+        SweepSlice *s = &(*slices)[(*n)++];
+        s->point = point;
+        s->first = m;
+        s->count = first + count - m < SWEEP_MATCHES_PER_JOB
+                 ? first + count - m : SWEEP_MATCHES_PER_JOB;
+    }
+    return 0;
+}
+
+// Play the jobs on the pool and add their tallies to their points
+static int play_slices(SweepContext *ctx, const SweepSlice *slices, int n,
+                       int jobs, SweepTally *totals) {
+    SweepTally *tallies = malloc((size_t)n * sizeof(SweepTally));
+    if (!tallies) {
+        perror("Sweep");
+        return -1;
+    }
+    ctx->slices = slices;
+    int status = pool_run(n, sizeof(SweepTally), tallies, jobs, sweep_job, ctx);
+    for (int i = 0; status == 0 && i < n; i++)
+        tally_add(&totals[slices[i].point], &tallies[i]);
+    free(tallies);
+    return status;
+}
+
+// ---------------------------------------------------------------------
+// run_sweep
+// ---------------------------------------------------------------------
+int run_sweep(const SweepAxis *axes, int naxes, int matches,
+              unsigned int base_seed, int jobs, const char *out_path) {
+    long points_l = 1;
+    for (int a = 0; a < naxes; a++) {
+        points_l *= axes[a].count;
+        if (points_l > 1000000) {
+            fprintf(stderr, "Sweep grid has more than 1000000 points\n");
+            return -1;
+        }
+    }
+    int points = (int)points_l;
+    int adaptive = target_width > 0.0;
+
+    SweepContext ctx;
+    ctx.axes = axes;
+    ctx.naxes = naxes;
+    ctx.slices = NULL;
+    ctx.base_seed = base_seed;
+    ctx.base = config;
+
+    // Validate every point up front; invalid ones are reported and skipped
+    char *valid = malloc((size_t)points);
+    SweepTally *totals = calloc((size_t)points, sizeof(SweepTally));
+    int *stops = calloc((size_t)points, sizeof(int));
+    FILE *out = fopen(out_path, "w");
+    if (export_dir && mkdir(export_dir, 0755) != 0 && errno != EEXIST) {
+        perror(export_dir);
+        if (out)
+            fclose(out);
+        out = NULL;
+    }
+    if (!valid || !totals || !stops || !out) {
+        perror("Sweep setup failed");
+        free(valid);
+        free(totals);
+        free(stops);
+        if (out)
+            fclose(out);
+        return -1;
+    }
+    int valid_points = 0;
+    for (int p = 0; p < points; p++) {
+        GameConfig cfg;
+        char err[256];
+        apply_point(&ctx, p, &cfg);
+        valid[p] = config_validate(&cfg, err, sizeof(err)) == 0;
+        if (valid[p])
+            valid_points++;
+        else
+            fprintf(stderr, "Sweep point %d skipped: %s\n", p, err);
+    }
+    ctx.valid = valid;
+
+    SweepSlice *slices = NULL;
+    int nslices = 0, slices_capacity = 0;
+    int status = 0;
+    int rounds = 0;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (!adaptive) {
+        // Every point plays all its matches in one pool run
+        for (int p = 0; p < points && status == 0; p++)
+            if (valid[p])
+                status = add_slices(&slices, &nslices, &slices_capacity, p, 0, matches);
+        if (status == 0)
+            status = play_slices(&ctx, slices, nslices, jobs, totals);
+        rounds = 1;
+    } else {
+        // Rounds of batches for the points that are still uncertain; all
+        // batches of a round share one pool run
+        int active = valid_points;
+        while (status == 0 && active > 0) {
+            nslices = 0;
+            for (int p = 0; p < points && status == 0; p++)
+                if (valid[p] && stops[p] == STOP_NONE)
+                    status = add_slices(&slices, &nslices, &slices_capacity, p,
+                                        totals[p].matches, next_batch(&totals[p], matches));
+            if (status == 0)
+                status = play_slices(&ctx, slices, nslices, jobs, totals);
+            rounds++;
+            for (int p = 0; p < points && status == 0; p++) {
+                if (valid[p] && stops[p] == STOP_NONE &&
+                    (stops[p] = stop_rule(&totals[p], matches)) != STOP_NONE)
+                    active--;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    if (status == 0) {
+        // Header: one column per axis, then the statistics
+        for (int a = 0; a < naxes; a++)
+            fprintf(out, "%s,", axes[a].field->name);
+        fprintf(out, "matches,team1_wins,team2_wins,ties,team1_win_rate,"
+                     "mean_ticks,mean_rounds,mean_abs_rope%s\n",
+                adaptive ? ",win_prob,ci_low,ci_high,stop" : "");
+
+        long played = 0;
+        int cached = 0;
+        int stopped_by[4] = {0, 0, 0, 0};
+        double widest = 0.0;
+        for (int p = 0; p < points; p++) {
+            if (!valid[p])
+                continue;
+            const SweepTally *sum = &totals[p];
+            played += sum->matches;
+            cached += sum->cached;
+
+            GameConfig cfg;
+            apply_point(&ctx, p, &cfg);
+            for (int a = 0; a < naxes; a++)
+                fprintf(out, "%g,", config_get_field(&cfg, axes[a].field));
+            double n = sum->matches > 0 ? (double)sum->matches : 1.0;
+            fprintf(out, "%d,%d,%d,%d,%.4f,%.1f,%.3f,%.3f",
+                    sum->matches, sum->wins[0], sum->wins[1], sum->ties,
+                    sum->wins[0] / n, sum->ticks / n, sum->rounds / n, sum->abs_rope / n);
+            if (adaptive) {
+                double low, high;
+                double prob = win_probability(sum, &low, &high);
+                fprintf(out, ",%.4f,%.4f,%.4f,%s", prob, low, high, stop_names[stops[p]]);
+                stopped_by[stops[p]]++;
+                if (high - low > widest)
+                    widest = high - low;
+            }
+            fprintf(out, "\n");
+        }
+        if (adaptive) {
+            printf("Sweep: %d points, %ld matches in %d rounds on %d workers in %.2f s -> %s\n",
+                   valid_points, played, rounds, jobs, secs, out_path);
+            printf("Adaptive: target 95%% CI width %.3f, %.1f matches per point on average "
+                   "(cap %d), widest CI %.3f; stopped by width %d, sprt %d, cap %d\n",
+                   target_width, valid_points > 0 ? (double)played / valid_points : 0.0,
+                   matches, widest, stopped_by[STOP_WIDTH], stopped_by[STOP_SPRT],
+                   stopped_by[STOP_MAX]);
+        } else {
+            printf("Sweep: %d points x %d matches on %d workers in %.2f s -> %s\n",
+                   valid_points, matches, jobs, secs, out_path);
+        }
+        if (cache_enabled())
+            printf("Cache: %d matches reused, %ld simulated\n", cached, played - cached);
+        if (export_dir)
+            printf("Export: per-tick columns in %s/\n", export_dir);
+    } else {
+        fprintf(stderr, "Sweep failed: a worker process did not finish\n");
+    }
+
+    fclose(out);
+    free(slices);
+    free(stops);
+    free(totals);
+    free(valid);
+    return status;
+}
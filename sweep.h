@@ -0,0 +1,48 @@
+// sweep.h
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stddef.h>
+#include "config.h"
+
+// Most values a single axis may expand to
+#define SWEEP_MAX_AXIS_VALUES 4096
+#define SWEEP_MAX_AXES 8
+
+// Narrowest target interval for adaptive sampling (about 4 million
+// matches per point at p = 0.5)
+#define SWEEP_MIN_CI_WIDTH 0.001
+
+// One dimension of the grid: a GameConfig field and the values it takes
+typedef struct {
+    const ConfigField *field;
+    int    count;
+    double values[SWEEP_MAX_AXIS_VALUES];
+} SweepAxis;
+
+// Parse "field=start:stop:step", "field=v1,v2,..." or "field=v"
+int sweep_parse_axis(const char *spec, SweepAxis *axis, char *err, size_t err_len);
+
+// Directory for per-tick exports (export.h), one file per job named
+// pointP_partC.tugcol; NULL (the default) exports nothing. While set,
+// every match is simulated, also when its result is cached.
+void sweep_set_export_dir(const char *dir);
+
+// Adaptive sampling: with width > 0, run_sweep plays each point in
+// rounds of parallel batches (seeds in the same order as a fixed sweep,
+// so cached results are reused) until the 95% Wilson interval of team 1's
+// win probability (ties count half) is at most width wide, or, if
+// sequential, until an SPRT of 0.5 -/+ width/2 decides which team is
+// favoured, or until `matches` have been played. Batches are sized from
+// the estimate so far, so close matchups get the samples and lopsided
+// ones stop early. 0 (the default) plays exactly `matches` per point.
+void sweep_set_target_width(double width, int sequential);
+
+// Play `matches` headless matches (the most per point, if adaptive) at
+// every grid point (seeds base_seed, base_seed+1, ... at each point) on
+// `jobs` worker processes and write one CSV row per point to out_path.
+// With no axes the grid is the current config alone. Returns 0 on success.
+int run_sweep(const SweepAxis *axes, int naxes, int matches,
+              unsigned int base_seed, int jobs, const char *out_path);
+
+#endif  // SWEEP_H
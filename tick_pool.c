@@ -0,0 +1,228 @@
+// Chunked ticks on a persistent thread pool (see tick_pool.h)
+#define _POSIX_C_SOURCE 200809L
+
+#include "tick_pool.h"
+#include "game.h"
+#include "game_clock.h"
+#include "kernel.h"
+#include "strategy.h"
+#include "realtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// What a dispatch runs on each chunk
+enum {
+    PHASE_FULL,      // Falls, recovery, energy step and effort sum
+    PHASE_FALLS,     // Falls and recovery (a strategy does the energy step)
+    PHASE_SUMS       // Effort sum only
+};
+
+int tick_chunked = 0;
+
+static int threads = 1;                 // Including the referee
+static int workers = 0;                 // Worker threads running
+static int started = 0;                 // Workers were started (or failed to)
+static pid_t owner_pid = 0;             // Process that chose the thread count
+static pthread_t worker_ids[TICK_POOL_MAX_THREADS];
+
+// Current dispatch (written by the referee before each generation)
+static int phase = PHASE_FULL;
+static const TickKernel *kernel = NULL;
+static uint64_t fall_base = 0;
+static int64_t  now_ns = 0;
+static int chunks_per_team = 0;
+static int total_chunks = 0;
+static int next_chunk = 0;              // Claimed with atomic adds
+
+static KernelSum *sums = NULL;          // Partial effort sum per chunk
+static int sums_capacity = 0;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t finished = PTHREAD_COND_INITIALIZER;
+static unsigned generation = 0;
+static int done = 0;                    // Workers finished with this generation
+static int quit = 0;
+
+// ---------------------------------------------------------------------
+// Per-chunk work
+// ---------------------------------------------------------------------
+
+// splitmix64 finalizer: the i-th output of the stream starting at base
+static inline uint64_t mix64(uint64_t base, uint64_t i) {
+    uint64_t x = base + i * 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// check_player_falls_partial and recover_players_partial for one chunk.
+// Each player only touches its own fields, so chunks are independent.
+static void falls_and_recovery(Player *row, int team, int begin, int end) {
+    const float p_fall = tick_params.fall_probability_per_tick;
+    const uint64_t first = (uint64_t)team * (uint64_t)config.players_per_team;
+    for (int p = begin; p < end; p++) {
+        Player *pl = &row[p];
+        if (pl->active && !pl->recovering) {
+            uint64_t h = mix64(fall_base, first + (uint64_t)p);
+            float r = (float)(h >> 40) * (1.0f / 16777216.0f);  // 24 bits in [0, 1)
+            if (r < p_fall) {
+                pl->recovering = 1;
+                pl->effort = 0.0f;
+                pl->recover_time = now_ns +
+                    ((int64_t)((uint32_t)h % (uint32_t)tick_params.recovery_span)
+                     + config.fall_recovery_min) * NSEC_PER_SEC;
+            }
+        }
+        if (pl->recovering && now_ns >= pl->recover_time) {
+            pl->recovering = 0;
+            pl->effort = pl->energy;
+        }
+    }
+}
+
+static void run_chunk(int index) {
+    int team = index / chunks_per_team;
+    int begin = (index % chunks_per_team) * TICK_CHUNK_PLAYERS;
+    int end = begin + TICK_CHUNK_PLAYERS;
+    if (end > config.players_per_team)
+        end = config.players_per_team;
+    Player *row = teams[team];
+
+    if (phase != PHASE_SUMS)
+        falls_and_recovery(row, team, begin, end);
+    if (phase == PHASE_FULL)
+        kernel->energy_chunk(row, begin, end);
+    if (phase != PHASE_FALLS)
+        sums[index] = kernel->effort_chunk(row, begin, end);
+}
+
+static void claim_chunks(void) {
+    int i;
+    while ((i = __atomic_fetch_add(&next_chunk, 1, __ATOMIC_RELAXED)) < total_chunks)
+        run_chunk(i);
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    unsigned seen = 0;
+    realtime_leave();  // Off a pinned referee's core
+    pthread_mutex_lock(&lock);
+    for (;;) {
+        while (generation == seen && !quit)
+            pthread_cond_wait(&start, &lock);
+        if (quit)
+            break;
+        seen = generation;
+        pthread_mutex_unlock(&lock);
+
+        claim_chunks();
+
+        pthread_mutex_lock(&lock);
+        if (++done == workers)
+            pthread_cond_signal(&finished);
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------
+// Referee side
+// ---------------------------------------------------------------------
+static void start_workers(void) {
+    started = 1;
+    workers = 0;
+    quit = 0;
+    for (int i = 0; i < threads - 1; i++) {
+        if (pthread_create(&worker_ids[i], NULL, worker_main, NULL) != 0) {
+            perror("tick pool thread");
+            break;
+        }
+        workers++;
+    }
+}
+
+// Run every chunk once in the given phase and wait for all of them
+static void dispatch(int which) {
+    phase = which;
+    next_chunk = 0;
+
+    // Only the process that chose the thread count runs threads; forked
+    // children (sweep workers, what-if branches) inherit the setting only
+    int own = owner_pid == getpid();
+    if (own && threads > 1 && !started)
+        start_workers();
+    if (!own || workers == 0 || total_chunks == 1) {
+        claim_chunks();
+        return;
+    }
+
+    pthread_mutex_lock(&lock);
+    done = 0;
+    generation++;
+    pthread_cond_broadcast(&start);
+    pthread_mutex_unlock(&lock);
+
+    claim_chunks();
+
+    pthread_mutex_lock(&lock);
+    while (done < workers)
+        pthread_cond_wait(&finished, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+void tick_pool_tick(void) {
+    chunks_per_team = (config.players_per_team + TICK_CHUNK_PLAYERS - 1) / TICK_CHUNK_PLAYERS;
+    total_chunks = config.num_teams * chunks_per_team;
+    if (total_chunks > sums_capacity) {
+        KernelSum *grown = realloc(sums, (size_t)total_chunks * sizeof(KernelSum));
+        if (!grown) {
+            perror("tick pool sums");
+            exit(EXIT_FAILURE);
+        }
+        sums = grown;
+        sums_capacity = total_chunks;
+    }
+
+    // Two draws per tick keep game_rng (and so checkpoints) the only RNG state
+    fall_base = ((uint64_t)(unsigned)game_rand() << 31) ^ (uint64_t)(unsigned)game_rand();
+    now_ns = game_clock_ns();
+    kernel = tick_kernel;
+
+    if (strategy_active()) {
+        dispatch(PHASE_FALLS);
+        strategy_energy_reports();
+        dispatch(PHASE_SUMS);
+    } else {
+        dispatch(PHASE_FULL);
+    }
+    kernel->rope_reduce(sums, chunks_per_team);
+}
+
+void tick_pool_set_threads(int n) {
+    tick_pool_stop();
+    owner_pid = getpid();
+    tick_chunked = n > 0;
+    threads = n < 1 ? 1 : n > TICK_POOL_MAX_THREADS ? TICK_POOL_MAX_THREADS : n;
+}
+
+int tick_pool_threads(void) {
+    return threads;
+}
+
+void tick_pool_stop(void) {
+    if (owner_pid == getpid() && workers > 0) {
+        pthread_mutex_lock(&lock);
+        quit = 1;
+        pthread_cond_broadcast(&start);
+        pthread_mutex_unlock(&lock);
+        for (int i = 0; i < workers; i++)
+            pthread_join(worker_ids[i], NULL);
+    }
+    workers = 0;
+    started = 0;
+}
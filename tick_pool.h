@@ -0,0 +1,45 @@
+// tick_pool.h
+#ifndef TICK_POOL_H
+#define TICK_POOL_H
+
+// ----------------------------------------------------------
+// Chunked ticks for giant rosters. Each team's players are split into
+// chunks of TICK_CHUNK_PLAYERS (a whole number of cache lines, since the
+// rows are 64-byte aligned) and a persistent thread pool runs falls,
+// recovery, the kernel's energy step and a partial effort sum per chunk;
+// the referee then adds the partial sums in chunk order and moves the
+// rope.
+//
+// Chunk boundaries and the reduction order do not depend on the number
+// of threads, and falls draw from a counter-based generator (one
+// game_rand() base per tick, hashed with the player's index) instead of
+// the sequential game_rand() stream, so a match plays out identically
+// with any thread count. It is not the match the serial engine plays
+// with the same seed: chunked ticks are part of the cache key and of
+// checkpoints. With --kernel fixed only the falls differ, since integer
+// sums do not depend on their order.
+//
+// Threads are only used by the process that set them; forked children
+// (sweep workers, what-if branches) run the chunks on their own thread,
+// with the same results.
+// ----------------------------------------------------------
+
+#define TICK_CHUNK_PLAYERS 1024
+#define TICK_POOL_MAX_THREADS 256
+
+// 1 while the chunked engine is selected (default 0: the serial engine)
+extern int tick_chunked;
+
+// Select chunked ticks on `threads` threads, the referee included
+// (0 switches back to the serial engine)
+void tick_pool_set_threads(int threads);
+int  tick_pool_threads(void);
+
+// Play the per-player part of one tick: falls, recovery, energy, team
+// sums and the rope (replaces the four *_partial steps)
+void tick_pool_tick(void);
+
+// Stop the worker threads
+void tick_pool_stop(void);
+
+#endif  // TICK_POOL_H
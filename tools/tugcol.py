@@ -0,0 +1,116 @@
+"""
+Reader for the per-tick export files written by tug_of_war --export
+(format described in export.h).
+
+    import tugcol
+    df = tugcol.read("match.tugcol")          # one file
+    df = tugcol.read("sweep_ticks/")          # every file of a sweep
+
+Returns a pandas DataFrame with one row per tick. Reading a directory
+adds a "file" column and one column per config value from each file's
+header (e.g. fall_probability), so sweep points can be grouped directly.
+DuckDB can query the frame as is: duckdb.sql("SELECT ... FROM df").
+
+Run as a script to print a summary: python3 tools/tugcol.py FILE|DIR
+"""
+import os
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b"TUGCOL\0\0"
+VERSION = 1
+
+TYPE_I64, TYPE_F32, TYPE_U8 = 0, 1, 2
+ENC_RAW, ENC_DELTA_RLE, ENC_RLE = 0, 1, 2
+
+_DTYPES = {TYPE_I64: np.int64, TYPE_F32: np.float32, TYPE_U8: np.uint8}
+
+
+def _decode(buf, off, length, ctype, enc, rows):
+    if enc == ENC_RAW:
+        return np.frombuffer(buf, _DTYPES[ctype], rows, off)
+    runs = struct.unpack_from("<I", buf, off)[0]
+    counts = np.frombuffer(buf, "<u4", runs, off + 4)
+    if enc == ENC_DELTA_RLE:
+        deltas = np.frombuffer(buf, "<i8", runs, off + 4 + 4 * runs)
+        return np.cumsum(np.repeat(deltas, counts))
+    if enc == ENC_RLE:
+        values = np.frombuffer(buf, np.uint8, runs, off + 4 + 4 * runs)
+        return np.repeat(values, counts)
+    raise ValueError("unknown encoding %d" % enc)
+
+
+def read_columns(path):
+    """Return (meta, {name: ndarray}) for one export file."""
+    with open(path, "rb") as f:
+        buf = f.read()
+    if buf[:8] != MAGIC:
+        raise ValueError("%s: not a tug export file" % path)
+    version, ncols, meta_len = struct.unpack_from("<III", buf, 8)
+    if version != VERSION:
+        raise ValueError("%s: format version %d, expected %d" % (path, version, VERSION))
+    off = 20
+    meta = {}
+    for item in buf[off:off + meta_len].decode().split(";"):
+        if "=" in item:
+            key, value = item.split("=", 1)
+            try:
+                meta[key] = float(value)
+            except ValueError:
+                meta[key] = value
+    off += meta_len
+
+    cols = []
+    for _ in range(ncols):
+        ctype, enc, name_len = struct.unpack_from("<BBH", buf, off)
+        off += 4
+        cols.append((buf[off:off + name_len].decode(), ctype, enc))
+        off += name_len
+
+    parts = {name: [] for name, _, _ in cols}
+    while off < len(buf):
+        rows, nbytes = struct.unpack_from("<II", buf, off)
+        off += 8
+        end = off + nbytes
+        for name, ctype, enc in cols:
+            length = struct.unpack_from("<I", buf, off)[0]
+            parts[name].append(_decode(buf, off + 4, length, ctype, enc, rows))
+            off += 4 + length
+        if off != end:
+            raise ValueError("%s: corrupt chunk" % path)
+
+    data = {}
+    for name, ctype, _ in cols:
+        chunks = parts[name]
+        data[name] = np.concatenate(chunks) if chunks else np.empty(0, _DTYPES[ctype])
+    return meta, data
+
+
+def read(path):
+    """Load a file, or every *.tugcol file in a directory, as a DataFrame."""
+    import pandas as pd
+
+    if not os.path.isdir(path):
+        return pd.DataFrame(read_columns(path)[1])
+
+    frames = []
+    for name in sorted(os.listdir(path)):
+        if not name.endswith(".tugcol"):
+            continue
+        meta, data = read_columns(os.path.join(path, name))
+        df = pd.DataFrame(data)
+        df.insert(0, "file", name)
+        for key, value in meta.items():
+            df[key] = value
+        frames.append(df)
+    return pd.concat(frames, ignore_index=True) if frames else pd.DataFrame()
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit("usage: tugcol.py FILE|DIR")
+    df = read(sys.argv[1])
+    print("%d rows, %d columns" % df.shape)
+    print(df.head())
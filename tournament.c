@@ -0,0 +1,373 @@
+/*
+ * Tournament scheduler.
+ * Generates a roster per team, schedules round-robin or knockout
+ * pairings and plays each batch of independent games on the fork-based
+ * worker pool. Results come back to the parent, which builds the next
+ * bracket round, the standings and the per-game CSV.
+ */
+#include "tournament.h"
+#include "game.h"
+#include "pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// One series between two teams
+typedef struct {
+    int a;
+    int b;
+} Pairing;
+
+// Outcome of one game, from the point of view of the pairing
+typedef struct {
+    int  winner;               // Team id, -1 for a tie
+    int  a_round_wins;
+    int  b_round_wins;
+    long ticks;
+} GameRecord;
+
+typedef struct {
+    int played;                // Series
+    int wins;
+    int draws;
+    int losses;
+    int game_wins;
+    int round_wins;
+    int reached;               // Knockout: last bracket round played
+    int eliminated;            // Knockout: lost a series
+} Standing;
+
+typedef struct {
+    const Pairing *pairings;
+    int            games;
+    int            round;
+    unsigned int   base_seed;
+    const Player  *rosters;    // nteams x players_per_team
+} TournamentContext;
+
+int tournament_parse_format(const char *name, TournamentFormat *format) {
+    if (strcmp(name, "roundrobin") == 0)
+        *format = TOURNAMENT_ROUND_ROBIN;
+    else if (strcmp(name, "knockout") == 0)
+        *format = TOURNAMENT_KNOCKOUT;
+    else
+        return -1;
+    return 0;
+}
+
+// ---------------------------------------------------------------------
+// Rosters and seeds
+// ---------------------------------------------------------------------
+
+// Players are drawn like initialize_game() draws them, from a per-team
+// seed, so a team is the same in every game it plays
+static void generate_rosters(Player *rosters, int nteams, unsigned int base_seed) {
+    for (int t = 0; t < nteams; t++) {
+        unsigned int rng = base_seed * 2654435761u + (unsigned int)t * 40503u + 1u;
+        for (int p = 0; p < config.players_per_team; p++) {
+            Player *pl = &rosters[(size_t)t * config.players_per_team + p];
+            memset(pl, 0, sizeof(*pl));
+            pl->energy = config.minimum_energy + (rand_r(&rng) % config.range) + (rand_r(&rng) % 20);
+            pl->decay_rate = 0.5f + (float)(rand_r(&rng) % 16) / 10.0f;
+        }
+    }
+}
+
+static unsigned int game_seed(const TournamentContext *ctx, const Pairing *pr, int game) {
+    unsigned int h = ctx->base_seed;
+    h = h * 31u + (unsigned int)ctx->round;
+    h = h * 1000003u + (unsigned int)pr->a;
+    h = h * 1000003u + (unsigned int)pr->b;
+    return h * 101u + (unsigned int)game;
+}
+
+// ---------------------------------------------------------------------
+// Pool job: one game of one pairing
+// ---------------------------------------------------------------------
+static void tournament_job(int job, void *out, void *arg) {
+    const TournamentContext *ctx = arg;
+    GameRecord *rec = out;
+    const Pairing *pr = &ctx->pairings[job / ctx->games];
+    int game = job % ctx->games;
+
+    // Workers each need their own shared block (the parent has none)
+    if (!shared_state && map_shared_state() != 0)
+        exit(EXIT_FAILURE);
+
+    // Sides alternate so neither team keeps the tie-break side
+    int side_a = game % 2;
+    const Player *rosters[NUM_TEAMS];
+    rosters[side_a]     = &ctx->rosters[(size_t)pr->a * config.players_per_team];
+    rosters[1 - side_a] = &ctx->rosters[(size_t)pr->b * config.players_per_team];
+
+    MatchResult r;
+    run_headless_match_rosters(game_seed(ctx, pr, game), rosters, &r);
+    rec->winner = r.winner < 0 ? -1 : (r.winner == side_a ? pr->a : pr->b);
+    rec->a_round_wins = r.round_wins[side_a];
+    rec->b_round_wins = r.round_wins[1 - side_a];
+    rec->ticks = r.ticks;
+}
+
+// Play every pairing of one batch; results are npairings x games records
+static int play_batch(TournamentContext *ctx, const Pairing *pairings, int npairings,
+                      GameRecord *records, int jobs) {
+    ctx->pairings = pairings;
+    return pool_run(npairings * ctx->games, sizeof(GameRecord), records, jobs,
+                    tournament_job, ctx);
+}
+
+// Tally one series; returns the series winner (-1 for a draw)
+static int score_series(const Pairing *pr, const GameRecord *records, int games,
+                        Standing *standings, int round, FILE *out) {
+    int a_games = 0, b_games = 0, a_rounds = 0, b_rounds = 0;
+    for (int g = 0; g < games; g++) {
+        const GameRecord *rec = &records[g];
+        if (rec->winner == pr->a)
+            a_games++;
+        else if (rec->winner == pr->b)
+            b_games++;
+        a_rounds += rec->a_round_wins;
+        b_rounds += rec->b_round_wins;
+        fprintf(out, "%d,%d,%d,%d,%d,%d,%d,%ld\n", round, g, pr->a + 1, pr->b + 1,
+                rec->winner < 0 ? 0 : rec->winner + 1,
+                rec->a_round_wins, rec->b_round_wins, rec->ticks);
+    }
+
+    Standing *sa = &standings[pr->a];
+    Standing *sb = &standings[pr->b];
+    sa->played++;
+    sb->played++;
+    sa->game_wins += a_games;
+    sb->game_wins += b_games;
+    sa->round_wins += a_rounds;
+    sb->round_wins += b_rounds;
+    sa->reached = sb->reached = round;
+
+    int winner = a_games > b_games ? pr->a : b_games > a_games ? pr->b : -1;
+    if (winner == pr->a) {
+        sa->wins++;
+        sb->losses++;
+    } else if (winner == pr->b) {
+        sb->wins++;
+        sa->losses++;
+    } else {
+        sa->draws++;
+        sb->draws++;
+    }
+    return winner;
+}
+
+// ---------------------------------------------------------------------
+// Formats
+// ---------------------------------------------------------------------
+static int play_round_robin(TournamentContext *ctx, int nteams, int jobs,
+                            Standing *standings, FILE *out) {
+    int npairings = nteams * (nteams - 1) / 2;
+    Pairing *pairings = malloc((size_t)npairings * sizeof(Pairing));
+    GameRecord *records = malloc((size_t)npairings * ctx->games * sizeof(GameRecord));
+    if (!pairings || !records) {
+        free(pairings);
+        free(records);
+        return -1;
+    }
+    int n = 0;
+    for (int a = 0; a < nteams; a++) {
+        for (int b = a + 1; b < nteams; b++) {
+            pairings[n].a = a;
+            pairings[n].b = b;
+            n++;
+        }
+    }
+
+    // Every pairing is independent: one batch
+    ctx->round = 1;
+    int status = play_batch(ctx, pairings, npairings, records, jobs);
+    if (status == 0) {
+        for (int i = 0; i < npairings; i++)
+            score_series(&pairings[i], &records[(size_t)i * ctx->games], ctx->games,
+                         standings, 1, out);
+    }
+    free(pairings);
+    free(records);
+    return status;
+}
+
+static int play_knockout(TournamentContext *ctx, int nteams, int jobs,
+                         Standing *standings, FILE *out, int *champion) {
+    // The bracket is padded to a power of two, so every bye is given in
+    // round 1 and later rounds pair all the teams left
+    int size = 2;
+    while (size < nteams)
+        size *= 2;
+    int *slots = malloc((size_t)size * sizeof(int));
+    int *slot_of = malloc((size_t)(size / 2) * sizeof(int));
+    Pairing *pairings = malloc((size_t)(size / 2) * sizeof(Pairing));
+    GameRecord *records = malloc((size_t)(size / 2) * ctx->games * sizeof(GameRecord));
+    if (!slots || !slot_of || !pairings || !records) {
+        free(slots);
+        free(slot_of);
+        free(pairings);
+        free(records);
+        return -1;
+    }
+
+    // Round 1 slot pairs; an empty slot (-1) is a bye. Byes go to every
+    // other pair first, so bye teams meet round 1 winners where they can.
+    int byes = size - nteams;
+    int quarter = size / 4;
+    int next_team = 0;
+    for (int i = 0; i < size / 2; i++) {
+        int bye = i % 2 == 0 ? i / 2 < byes : i / 2 < byes - quarter;
+        slots[2 * i] = next_team++;
+        slots[2 * i + 1] = bye ? -1 : next_team++;
+    }
+    int nslots = size;
+    int status = 0;
+
+    // Each bracket round depends on the previous one, so rounds run as
+    // separate batches; the series inside a round run in parallel
+    for (int round = 1; nslots > 1 && status == 0; round++) {
+        int npairings = 0;
+        for (int i = 0; i < nslots / 2; i++) {
+            if (slots[2 * i + 1] < 0)
+                continue;
+            pairings[npairings].a = slots[2 * i];
+            pairings[npairings].b = slots[2 * i + 1];
+            slot_of[npairings++] = i;
+        }
+        ctx->round = round;
+        status = play_batch(ctx, pairings, npairings, records, jobs);
+        if (status != 0)
+            break;
+
+        // Byes advance as they are (slots[2i] moves to slots[i])
+        for (int i = 0; i < nslots / 2; i++) {
+            if (slots[2 * i + 1] < 0) {
+                standings[slots[2 * i]].reached = round;
+                slots[i] = slots[2 * i];
+            }
+        }
+        for (int i = 0; i < npairings; i++) {
+            const Pairing *pr = &pairings[i];
+            const GameRecord *recs = &records[(size_t)i * ctx->games];
+            int winner = score_series(pr, recs, ctx->games, standings, round, out);
+            if (winner < 0) {
+                // Drawn series: more round wins, then the lower team number
+                int a_rounds = 0, b_rounds = 0;
+                for (int g = 0; g < ctx->games; g++) {
+                    a_rounds += recs[g].a_round_wins;
+                    b_rounds += recs[g].b_round_wins;
+                }
+                winner = b_rounds > a_rounds ? pr->b : pr->a;
+            }
+            standings[winner == pr->a ? pr->b : pr->a].eliminated = 1;
+            slots[slot_of[i]] = winner;
+        }
+        nslots /= 2;
+    }
+    *champion = slots[0];
+    free(slots);
+    free(slot_of);
+    free(pairings);
+    free(records);
+    return status;
+}
+
+// ---------------------------------------------------------------------
+// run_tournament
+// ---------------------------------------------------------------------
+static const Standing *sort_standings;
+static TournamentFormat sort_format;
+
+static int compare_standing(const void *x, const void *y) {
+    int a = *(const int *)x, b = *(const int *)y;
+    const Standing *sa = &sort_standings[a], *sb = &sort_standings[b];
+    if (sort_format == TOURNAMENT_KNOCKOUT) {
+        // Further in the bracket first; on the same round the team that
+        // won there (only the champion) ranks above the ones that lost
+        if (sa->reached != sb->reached)
+            return sb->reached - sa->reached;
+        if (sa->eliminated != sb->eliminated)
+            return sa->eliminated - sb->eliminated;
+    }
+    int pa = 2 * sa->wins + sa->draws, pb = 2 * sb->wins + sb->draws;
+    if (pa != pb)
+        return pb - pa;
+    if (sa->game_wins != sb->game_wins)
+        return sb->game_wins - sa->game_wins;
+    if (sa->round_wins != sb->round_wins)
+        return sb->round_wins - sa->round_wins;
+    return a - b;
+}
+
+int run_tournament(TournamentFormat format, int nteams, int games,
+                   unsigned int base_seed, int jobs, const char *out_path) {
+    if (nteams < 2 || nteams > TOURNAMENT_MAX_TEAMS) {
+        fprintf(stderr, "Tournament needs 2 to %d teams\n", TOURNAMENT_MAX_TEAMS);
+        return -1;
+    }
+
+    Player *rosters = malloc((size_t)nteams * config.players_per_team * sizeof(Player));
+    Standing *standings = calloc((size_t)nteams, sizeof(Standing));
+    int *order = malloc((size_t)nteams * sizeof(int));
+    FILE *out = fopen(out_path, "w");
+    if (!rosters || !standings || !order || !out) {
+        perror("Tournament setup failed");
+        free(rosters);
+        free(standings);
+        free(order);
+        if (out)
+            fclose(out);
+        return -1;
+    }
+    generate_rosters(rosters, nteams, base_seed);
+    fprintf(out, "round,game,team_a,team_b,winner,a_round_wins,b_round_wins,ticks\n");
+
+    TournamentContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.games = games;
+    ctx.base_seed = base_seed;
+    ctx.rosters = rosters;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int champion = -1;
+    int status = format == TOURNAMENT_ROUND_ROBIN
+               ? play_round_robin(&ctx, nteams, jobs, standings, out)
+               : play_knockout(&ctx, nteams, jobs, standings, out, &champion);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    if (status == 0) {
+        for (int t = 0; t < nteams; t++)
+            order[t] = t;
+        sort_standings = standings;
+        sort_format = format;
+        qsort(order, (size_t)nteams, sizeof(int), compare_standing);
+
+        printf("=== %s TOURNAMENT: %d teams, %d games per pairing ===\n",
+               format == TOURNAMENT_ROUND_ROBIN ? "ROUND-ROBIN" : "KNOCKOUT", nteams, games);
+        printf("Rank | Team | Series W-D-L | Games won | Rounds won%s\n",
+               format == TOURNAMENT_KNOCKOUT ? " | Reached round" : "");
+        for (int i = 0; i < nteams; i++) {
+            const Standing *s = &standings[order[i]];
+            printf("%4d | %4d | %5d-%d-%-4d | %9d | %10d", i + 1, order[i] + 1,
+                   s->wins, s->draws, s->losses, s->game_wins, s->round_wins);
+            if (format == TOURNAMENT_KNOCKOUT)
+                printf(" | %d", s->reached);
+            printf("\n");
+        }
+        if (champion >= 0)
+            printf("Champion: Team %d\n", champion + 1);
+        printf("Tournament: played on %d workers in %.2f s -> %s\n", jobs, secs, out_path);
+    } else {
+        fprintf(stderr, "Tournament failed: a worker process did not finish\n");
+    }
+
+    fclose(out);
+    free(order);
+    free(standings);
+    free(rosters);
+    return status;
+}
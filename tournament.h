@@ -0,0 +1,29 @@
+// tournament.h
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+// ----------------------------------------------------------
+// Tournament mode: T teams with fixed rosters generated from config play
+// a round-robin or single-elimination bracket of headless matches on the
+// worker pool. Every pairing is a series of games with the teams swapping
+// sides each game; all series that do not depend on each other (the whole
+// round robin, or one bracket round) run as one parallel batch.
+// ----------------------------------------------------------
+
+#define TOURNAMENT_MAX_TEAMS 4096
+
+typedef enum {
+    TOURNAMENT_ROUND_ROBIN,
+    TOURNAMENT_KNOCKOUT
+} TournamentFormat;
+
+// "roundrobin" or "knockout"; returns -1 for anything else
+int tournament_parse_format(const char *name, TournamentFormat *format);
+
+// Play the tournament with `games` games per pairing on `jobs` workers,
+// print the standings and write one CSV row per game to out_path.
+// Returns 0 on success.
+int run_tournament(TournamentFormat format, int nteams, int games,
+                   unsigned int base_seed, int jobs, const char *out_path);
+
+#endif  // TOURNAMENT_H
@@ -0,0 +1,236 @@
+// ANSI terminal viewer (see tty.h)
+#define _POSIX_C_SOURCE 200809L
+
+#include "tty.h"
+#include "state.h"
+#include "shm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TTY_COLS 80
+#define TTY_ROWS (8 + NUM_TEAMS * (PLAYERS_PER_TEAM + 2))
+
+// Seconds the final result stays on screen
+#define TTY_RESULT_SECONDS 5
+
+// Cell colors (SGR foreground codes; 0 = default)
+enum {
+    COLOR_DEFAULT = 0,
+    COLOR_RED     = 31,
+    COLOR_GREEN   = 32,
+    COLOR_YELLOW  = 33,
+    COLOR_BLUE    = 34,
+    COLOR_GRAY    = 90
+};
+
+typedef struct {
+    char          ch;
+    unsigned char color;
+} Cell;
+
+static const unsigned char team_colors[NUM_TEAMS] = { COLOR_BLUE, COLOR_GREEN };
+
+static Cell screen[TTY_ROWS][TTY_COLS];     // Frame being drawn
+static Cell shown[TTY_ROWS][TTY_COLS];      // What the terminal shows now
+static volatile sig_atomic_t tty_stop = 0;
+
+static void stop_handler(int sig) {
+    (void)sig;
+    tty_stop = 1;
+}
+
+// ---------------------------------------------------------------------
+// Drawing into the cell grid
+// ---------------------------------------------------------------------
+static void put_text(int row, int col, unsigned char color, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static void put_text(int row, int col, unsigned char color, const char *fmt, ...) {
+    char buf[TTY_COLS + 1];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    for (int i = 0; buf[i] && col + i < TTY_COLS; i++) {
+        screen[row][col + i].ch = buf[i];
+        screen[row][col + i].color = color;
+    }
+}
+
+static void put_char(int row, int col, unsigned char color, char ch) {
+    if (col >= 0 && col < TTY_COLS) {
+        screen[row][col].ch = ch;
+        screen[row][col].color = color;
+    }
+}
+
+static void draw_frame(const SharedState *st) {
+    for (int r = 0; r < TTY_ROWS; r++) {
+        for (int c = 0; c < TTY_COLS; c++) {
+            screen[r][c].ch = ' ';
+            screen[r][c].color = COLOR_DEFAULT;
+        }
+    }
+
+    // Header
+    put_text(0, 0, COLOR_DEFAULT,
+             "Time: %d sec | Round: %d | Team1 Wins: %d | Team2 Wins: %d | Rope: %.1f/%.1f",
+             st->elapsed_seconds, st->round_number, st->team_round_wins[0],
+             st->team_round_wins[1], st->rope_position, st->rope_threshold);
+    if (st->whatif_branches > 0)
+        put_text(1, 0, COLOR_DEFAULT, "P(win): Team1 %.0f%% | Team2 %.0f%% (%d branches)",
+                 st->win_probability[0] * 100.0f, st->win_probability[1] * 100.0f,
+                 st->whatif_branches);
+    if (st->time_warp > 0.0f && st->time_warp != 1.0f)
+        put_text(1, TTY_COLS - 14, COLOR_DEFAULT, "Warp: %.2fx", st->time_warp);
+
+    // Rope: a track with the center line and the knot, displaced the way
+    // the OpenGL view moves it
+    int left = 10, width = TTY_COLS - 20, center = left + width / 2;
+    for (int c = left; c < left + width; c++)
+        put_char(3, c, COLOR_YELLOW, '-');
+    put_char(3, center, COLOR_DEFAULT, '|');
+    float frac = st->rope_threshold > 0.0f ? st->rope_position / st->rope_threshold : 0.0f;
+    if (frac > 1.0f)
+        frac = 1.0f;
+    if (frac < -1.0f)
+        frac = -1.0f;
+    put_char(3, center - (int)(frac * (width / 2 - 1)), COLOR_RED, 'O');
+    put_text(3, 0, team_colors[0], "Team 1");
+    put_text(3, left + width + 4, team_colors[1], "Team 2");
+
+    // Players: energy bars scaled to the strongest player on the field
+    float max_energy = 1.0f;
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        for (int p = 0; p < PLAYERS_PER_TEAM; p++) {
+            if (st->players[t][p].energy > max_energy)
+                max_energy = st->players[t][p].energy;
+        }
+    }
+    int row = 5;
+    for (int t = 0; t < NUM_TEAMS; t++) {
+        put_text(row++, 0, team_colors[t], "Team %d  total effort %.1f", t + 1, st->team_efforts[t]);
+        for (int p = 0; p < PLAYERS_PER_TEAM; p++, row++) {
+            const Player *pl = &st->players[t][p];
+            put_text(row, 2, COLOR_DEFAULT, "P%d pos %d", p + 1, pl->position);
+            int bar = 30;
+            int filled = (int)(pl->energy / max_energy * bar + 0.5f);
+            put_char(row, 14, COLOR_DEFAULT, '[');
+            for (int i = 0; i < bar; i++)
+                put_char(row, 15 + i, pl->recovering ? COLOR_GRAY : team_colors[t],
+                         i < filled ? '#' : ' ');
+            put_char(row, 15 + bar, COLOR_DEFAULT, ']');
+            put_text(row, 17 + bar, COLOR_DEFAULT, "%6.1f", pl->energy);
+            if (pl->recovering)
+                put_text(row, 25 + bar, COLOR_RED, "X FALLEN");
+            else
+                put_text(row, 25 + bar, COLOR_DEFAULT, "effort %.1f", pl->effort);
+        }
+        row++;
+    }
+
+    if (st->game_ended) {
+        put_text(row, 0, COLOR_RED, "TEAM %d IS THE WINNER!  Final Score: Team1=%d  |  Team2=%d",
+                 st->final_winner + 1, st->team_round_wins[0], st->team_round_wins[1]);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Sending only the changed cells
+// ---------------------------------------------------------------------
+static void write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, buf, len);
+        if (n <= 0)
+            return;
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+static void write_str(const char *s) {
+    write_all(s, strlen(s));
+}
+
+static void flush_changes(void) {
+    static char out[TTY_ROWS * TTY_COLS * 16];
+    size_t len = 0;
+    int color = -1;
+    for (int r = 0; r < TTY_ROWS; r++) {
+        int cursor = -1;  // Column the terminal cursor is at on this row
+        for (int c = 0; c < TTY_COLS; c++) {
+            Cell cell = screen[r][c];
+            if (cell.ch == shown[r][c].ch && cell.color == shown[r][c].color)
+                continue;
+            if (cursor != c)
+                len += (size_t)snprintf(out + len, sizeof(out) - len, "\x1b[%d;%dH", r + 1, c + 1);
+            if (cell.color != color) {
+                len += (size_t)snprintf(out + len, sizeof(out) - len, "\x1b[%dm", cell.color);
+                color = cell.color;
+            }
+            out[len++] = cell.ch;
+            cursor = c + 1;
+            shown[r][c] = cell;
+        }
+    }
+    if (len > 0) {
+        len += (size_t)snprintf(out + len, sizeof(out) - len, "\x1b[0m\x1b[%d;1H", TTY_ROWS + 1);
+        write_all(out, len);
+    }
+}
+
+// ---------------------------------------------------------------------
+// tty_viewer_run
+// ---------------------------------------------------------------------
+void tty_viewer_run(int fps) {
+    if (fps < 1)
+        fps = 1;
+    long frame_nsec = 1000000000L / fps;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = stop_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    // Clear the screen and hide the cursor; every cell starts as "unknown"
+    memset(shown, 0, sizeof(shown));
+    write_str("\x1b[2J\x1b[?25l");
+
+    SharedState st;
+    uint32_t last_generation = 1;   // Odd: never a published generation
+    time_t ended_at = 0;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (!tty_stop) {
+        uint32_t generation = __atomic_load_n(&shared_segment->header.generation,
+                                              __ATOMIC_ACQUIRE);
+        if (generation != last_generation) {
+            shm_read(&st);
+            draw_frame(&st);
+            flush_changes();
+            last_generation = generation;
+            if (st.game_ended && ended_at == 0)
+                ended_at = time(NULL);
+        }
+        if (ended_at && time(NULL) - ended_at > TTY_RESULT_SECONDS)
+            break;
+
+        // Never more than fps frames per second
+        next.tv_nsec += frame_nsec;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    write_str("\x1b[0m\x1b[?25h\n");  // Restore colors and the cursor
+}
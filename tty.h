@@ -0,0 +1,19 @@
+// tty.h
+#ifndef TTY_H
+#define TTY_H
+
+// ----------------------------------------------------------
+// ANSI terminal front end: draws the header, the rope, every player's
+// energy bar with fallen markers and the team efforts from SharedState.
+// Each frame is drawn into a cell grid and only the cells that differ
+// from the previous frame are sent, so an idle match costs almost no
+// output. Needs no OpenGL.
+// ----------------------------------------------------------
+
+#define TTY_DEFAULT_FPS 10
+
+// Draw frames from shared_state at most fps times per second until the
+// match has ended (plus a few seconds for the result) or SIGINT/SIGTERM
+void tty_viewer_run(int fps);
+
+#endif  // TTY_H
@@ -0,0 +1,178 @@
+// Fork-based what-if branching (see whatif.h)
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include "whatif.h"
+#include "game.h"
+#include "log.h"
+#include "checkpoint.h"
+#include "shm.h"
+#include "game_clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+static int   branches = 0;                      // Branches per batch, 0 = off
+static pid_t branch_pids[WHATIF_MAX_BRANCHES];
+static int   running = 0;                       // Branches started in this batch
+static int   results_in = 0;                    // Results received so far
+static int   wins[NUM_TEAMS];
+static int   ties = 0;
+static int   result_fd = -1;                    // Read end of the result pipe
+static long  last_batch_tick = -WHATIF_INTERVAL_TICKS;
+static unsigned int batch_number = 0;
+
+void whatif_enable(int k) {
+    if (k > WHATIF_MAX_BRANCHES)
+        k = WHATIF_MAX_BRANCHES;
+    branches = k > 0 ? k : 0;
+}
+
+// ---------------------------------------------------------------------
+// Branch side (runs in the forked child)
+// ---------------------------------------------------------------------
+static void run_branch(int write_fd, unsigned int seed) {
+    // Continue on a private copy: nothing from here on may reach the
+    // visualizer or the real player processes
+    log_set_level(LOG_LEVEL_OFF);
+    checkpoint_enable(NULL, 0);
+    SharedState live;
+    shm_read(&live);
+    if (map_shared_state() != 0)
+        _exit(EXIT_FAILURE);
+    memcpy(shared_state, &live, sizeof(SharedState));
+    for (int t = 0; t < config.num_teams; t++) {
+        for (int p = 0; p < config.players_per_team; p++) {
+            teams[t][p].pid = 0;
+        }
+    }
+
+    // Switch to the headless clock at the current point of the match, so
+    // pending recover_time values stay meaningful
+    sim_ticks = (long)(game_clock_ns() / TICK_NSEC);
+    headless = 1;
+    game_srand(seed);
+
+    referee_control();
+
+    unsigned char outcome = 2;  // Tie
+    if (shared_state->game_ended)
+        outcome = (unsigned char)shared_state->final_winner;
+    if (write(write_fd, &outcome, 1) != 1)
+        _exit(EXIT_FAILURE);
+    _exit(EXIT_SUCCESS);
+}
+
+// ---------------------------------------------------------------------
+// Referee side
+// ---------------------------------------------------------------------
+static void reap_branches(int block) {
+    for (int i = 0; i < running; i++) {
+        if (branch_pids[i] > 0 &&
+            waitpid(branch_pids[i], NULL, block ? 0 : WNOHANG) == branch_pids[i])
+            branch_pids[i] = 0;
+    }
+}
+
+static void start_batch(void) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        LOG_WARN("what-if: pipe failed, skipping this batch\n");
+        return;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    batch_number++;
+    running = 0;
+    results_in = 0;
+    ties = 0;
+    for (int t = 0; t < NUM_TEAMS; t++)
+        wins[t] = 0;
+
+    for (int k = 0; k < branches; k++) {
+        unsigned int seed = (unsigned int)(batch_number * 7919u + k * 104729u) ^ (unsigned int)getpid();
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            run_branch(fds[1], seed);
+        }
+        if (pid < 0)
+            break;
+        branch_pids[running++] = pid;
+    }
+    close(fds[1]);
+    result_fd = fds[0];
+    last_batch_tick = sim_ticks;
+}
+
+// Publish the finished batch as the current estimate
+static void publish_estimate(void) {
+    if (results_in == 0)
+        return;
+    // A tie counts as half a win for each side
+    shm_write_begin();
+    for (int t = 0; t < NUM_TEAMS; t++)
+        shared_state->win_probability[t] = (wins[t] + 0.5f * ties) / (float)results_in;
+    shared_state->whatif_branches = results_in;
+    shm_write_end();
+    LOG_DEBUG("what-if: Team 1 %.0f%%, Team 2 %.0f%% over %d branches\n",
+              shared_state->win_probability[0] * 100.0f,
+              shared_state->win_probability[1] * 100.0f, results_in);
+}
+
+static void collect_results(void) {
+    unsigned char buf[WHATIF_MAX_BRANCHES];
+    for (;;) {
+        ssize_t n = read(result_fd, buf, sizeof(buf));
+        if (n > 0) {
+            for (ssize_t i = 0; i < n; i++) {
+                if (buf[i] < NUM_TEAMS)
+                    wins[buf[i]]++;
+                else
+                    ties++;
+            }
+            results_in += (int)n;
+            continue;
+        }
+        if (n == 0) {
+            // Every branch has exited: the batch is complete
+            close(result_fd);
+            result_fd = -1;
+            reap_branches(1);
+            publish_estimate();
+        }
+        // n < 0 with EAGAIN: branches still running
+        return;
+    }
+}
+
+void whatif_tick(void) {
+    if (branches == 0)
+        return;
+    if (result_fd >= 0) {
+        collect_results();
+        reap_branches(0);
+    }
+    if (result_fd < 0 && sim_ticks - last_batch_tick >= WHATIF_INTERVAL_TICKS)
+        start_batch();
+}
+
+void whatif_stop(void) {
+    for (int i = 0; i < running; i++) {
+        if (branch_pids[i] > 0)
+            kill(branch_pids[i], SIGKILL);
+    }
+    reap_branches(1);
+    running = 0;
+    if (result_fd >= 0) {
+        close(result_fd);
+        result_fd = -1;
+    }
+}
@@ -0,0 +1,29 @@
+// whatif.h
+#ifndef WHATIF_H
+#define WHATIF_H
+
+// ----------------------------------------------------------
+// What-if branching: every WHATIF_INTERVAL_TICKS the referee fork()s K
+// copy-on-write branches of the live match. Each branch plays the rest
+// of the match headless with its own RNG seed and reports the winner
+// through a pipe. The share of branches each team wins is published in
+// SharedState as a live win-probability estimate.
+// ----------------------------------------------------------
+
+// Start a new batch of branches this often (one game second)
+#define WHATIF_INTERVAL_TICKS TICKS_PER_SECOND
+
+// Most branches per batch
+#define WHATIF_MAX_BRANCHES 256
+
+// Enable branching with k branches per batch (0 disables)
+void whatif_enable(int k);
+
+// Called by the referee once per tick: collects finished branches,
+// publishes the estimate and starts the next batch when due
+void whatif_tick(void);
+
+// Kill and reap any branches still running
+void whatif_stop(void);
+
+#endif  // WHATIF_H